@@ -0,0 +1,143 @@
+// Times the stages of the Mu-Law/A-Law pipeline separately: decimate, compand and
+// interpolate, per host sample and channel.
+//
+// The resampler stages are timed on an engine of their own, driven the way the
+// processors drive theirs (256-sample sub-blocks, each channel decimated and then
+// interpolated), with the clock read around each call; that adds two clock reads per
+// 256 samples to the stages. compand() only exists inside the processors, so its
+// share is what a whole processBlock() costs on top of the two resampler stages.
+
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+
+#include "CompanderProcessor.h"
+#include "ResamplingEngine.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+    // as in MuLawProcessor and ALawProcessor
+    constexpr int subBlockSize = 256;
+
+    struct StageTimes
+    {
+        double decimate = 0.0;
+        double interpolate = 0.0;
+        double processBlock = 0.0;
+    };
+
+    void fill(juce::AudioBuffer<float>& buffer, int block)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                data[sample] = 0.5f * std::sin(0.013f * static_cast<float>(block * buffer.getNumSamples() + sample));
+        }
+    }
+
+    double perSample(Nanoseconds elapsed, const juce::dsp::ProcessSpec& spec, int numBlocks)
+    {
+        return elapsed.count() / (static_cast<double>(numBlocks) * spec.maximumBlockSize * spec.numChannels);
+    }
+
+    // nanoseconds per host sample and channel, each the best of several runs; the engine and the processor
+    // take turns block by block, so clock drift lands on both and the difference stays meaningful
+    template <typename Processor>
+    StageTimes time(const juce::dsp::ProcessSpec& spec, int factor, int numBlocks)
+    {
+        ResamplingEngine engine;
+        engine.prepare(spec);
+        engine.setFactor(factor);
+
+        Processor processor;
+        processor.prepare(spec);
+
+        CodecProcessorParameters params;
+        params = processor.getParameters();
+        params.downsampling = factor;
+        processor.setParameters(params);
+
+        juce::AudioBuffer<float> buffer(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+        juce::MidiBuffer midiMessages;
+        StageTimes best;
+
+        for (int run = 0; run < 5; ++run)
+        {
+            Nanoseconds decimate { 0.0 }, interpolate { 0.0 }, processBlock { 0.0 };
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fill(buffer, block);
+
+                for (int start = 0; start < buffer.getNumSamples(); start += subBlockSize)
+                {
+                    int numSamples = juce::jmin(subBlockSize, buffer.getNumSamples() - start);
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    {
+                        auto* channelData = buffer.getWritePointer(channel) + start;
+
+                        auto before = Clock::now();
+                        engine.decimate(channel, channelData, numSamples);
+                        auto between = Clock::now();
+                        engine.interpolate(channel, channelData, numSamples);
+                        auto after = Clock::now();
+
+                        decimate += between - before;
+                        interpolate += after - between;
+                    }
+                }
+
+                fill(buffer, block);
+
+                auto before = Clock::now();
+                processor.processBlock(buffer, midiMessages);
+                processBlock += Clock::now() - before;
+            }
+
+            StageTimes times { perSample(decimate, spec, numBlocks), perSample(interpolate, spec, numBlocks),
+                               perSample(processBlock, spec, numBlocks) };
+
+            best.decimate = run == 0 ? times.decimate : juce::jmin(best.decimate, times.decimate);
+            best.interpolate = run == 0 ? times.interpolate : juce::jmin(best.interpolate, times.interpolate);
+            best.processBlock = run == 0 ? times.processBlock : juce::jmin(best.processBlock, times.processBlock);
+        }
+
+        return best;
+    }
+
+    template <typename Processor>
+    void printStages(const char* name, const juce::dsp::ProcessSpec& spec, int numBlocks)
+    {
+        const int factors[] = { 1, 2, 4, 8 };
+
+        std::printf("\n%s, %.0f Hz stereo, %u-sample blocks, ns per sample and channel\n", name, spec.sampleRate, spec.maximumBlockSize);
+        std::printf("%8s %10s %10s %12s %14s\n", "factor", "decimate", "compand", "interpolate", "processBlock");
+
+        for (int factor : factors)
+        {
+            auto times = time<Processor>(spec, factor, numBlocks);
+
+            std::printf("%8d %10.2f %10.2f %12.2f %14.2f\n", factor, times.decimate,
+                        times.processBlock - times.decimate - times.interpolate, times.interpolate, times.processBlock);
+        }
+    }
+}
+
+int main()
+{
+    juce::dsp::ProcessSpec spec { 48000.0, 512, 2 };
+    int numBlocks = juce::roundToInt(spec.sampleRate * 10.0 / spec.maximumBlockSize);
+
+    std::printf("compand is processBlock less the two resampler stages\n");
+
+    printStages<MuLawProcessor>("Mu-Law", spec, numBlocks);
+    printStages<ALawProcessor>("A-Law", spec, numBlocks);
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Compares CodecSlot's std::variant dispatch with the virtual interface it replaced.
+//
+// Both sides run the same processors with the same per-block work (copy the slot
+// parameters in, then processBlock), so the difference is the dispatch itself: a
+// visit over CodecVariant versus a virtual call through a heap-allocated base.
+// "None" isolates the call overhead; the codecs show how much of it survives
+// real work. Small blocks are where it matters.
+
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "CodecSlot.h"
+
+namespace
+{
+    // the pre-variant interface: one virtual call per block, processor behind a pointer
+    struct VirtualCodec
+    {
+        virtual ~VirtualCodec() = default;
+        virtual void prepare(const juce::dsp::ProcessSpec& spec) = 0;
+        virtual void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) = 0;
+        virtual CodecProcessorParameters& getParameters() = 0;
+        virtual void setParameters(const CodecProcessorParameters& params) = 0;
+    };
+
+    struct VirtualNone final : VirtualCodec
+    {
+        void prepare(const juce::dsp::ProcessSpec&) override {}
+        void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+        CodecProcessorParameters& getParameters() override { return parameters; }
+        void setParameters(const CodecProcessorParameters& params) override { parameters = params; }
+
+        CodecProcessorParameters parameters;
+    };
+
+    template <typename Processor>
+    struct VirtualProcessor final : VirtualCodec
+    {
+        void prepare(const juce::dsp::ProcessSpec& spec) override { processor.prepare(spec); }
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override { processor.processBlock(buffer, midiMessages); }
+        CodecProcessorParameters& getParameters() override { return processor.getParameters(); }
+        void setParameters(const CodecProcessorParameters& params) override { processor.setParameters(params); }
+
+        Processor processor;
+    };
+
+    // same indices as CodecVariant
+    std::unique_ptr<VirtualCodec> createVirtual(int codec)
+    {
+        switch (codec)
+        {
+            case 1: return std::make_unique<VirtualProcessor<GSMProcessor>>();
+            case 2: return std::make_unique<VirtualProcessor<MuLawProcessor>>();
+            case 3: return std::make_unique<VirtualProcessor<ALawProcessor>>();
+            case 4: return std::make_unique<VirtualProcessor<VoxProcessor>>();
+            default: return std::make_unique<VirtualNone>();
+        }
+    }
+
+    void fill(juce::AudioBuffer<float>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                data[sample] = 0.5f * std::sin(0.01f * static_cast<float>(sample));
+        }
+    }
+
+    // the same per-block work as CodecSlot::process
+    void updateAndProcess(CodecVariant& variant, CodecProcessorParameters& slotParameters,
+                          juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params)
+    {
+        std::visit([&](auto& processor)
+        {
+            if constexpr (! std::is_same_v<std::decay_t<decltype(processor)>, std::monostate>)
+            {
+                slotParameters = processor.getParameters();
+                slotParameters.downsampling = params.downsampling;
+                slotParameters.bitrate = params.bitrate;
+                slotParameters.companderBits = params.companderBits;
+
+                processor.setParameters(slotParameters);
+                processor.processBlock(buffer, midiMessages);
+            }
+        }, variant);
+    }
+
+    void updateAndProcess(VirtualCodec& codec, CodecProcessorParameters& slotParameters,
+                          juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params)
+    {
+        slotParameters = codec.getParameters();
+        slotParameters.downsampling = params.downsampling;
+        slotParameters.bitrate = params.bitrate;
+        slotParameters.companderBits = params.companderBits;
+
+        codec.setParameters(slotParameters);
+        codec.processBlock(buffer, midiMessages);
+    }
+
+    // nanoseconds per block, best of several runs
+    template <typename Codec>
+    double time(Codec& codec, int blockSize, int numBlocks, const CodecProcessorParameters& params)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midiMessages;
+        CodecProcessorParameters slotParameters;
+        double best = 0.0;
+
+        // the processors work in place; what they are fed doesn't change their cost
+        fill(buffer);
+
+        for (int run = 0; run < 5; ++run)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+                updateAndProcess(codec, slotParameters, buffer, midiMessages, params);
+
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            double perBlock = elapsed.count() / numBlocks;
+
+            if (run == 0 || perBlock < best)
+                best = perBlock;
+        }
+
+        return best;
+    }
+}
+
+int main()
+{
+    const char* names[] = { "None", "GSM 06.10", "Mu-Law", "A-Law", "Vox" };
+    const int blockSizes[] = { 16, 64, 512 };
+
+    CodecProcessorParameters params;
+    params.downsampling = 1;
+    params.bitrate = 2;
+
+    std::printf("%-10s %6s %14s %14s %8s\n", "codec", "block", "variant ns", "virtual ns", "ratio");
+
+    for (int blockSize : blockSizes)
+    {
+        juce::dsp::ProcessSpec spec { 48000.0, static_cast<juce::uint32>(blockSize), 2 };
+        int numBlocks = 2000000 / blockSize;
+
+        for (int codec = 0; codec < static_cast<int>(std::variant_size_v<CodecVariant>); ++codec)
+        {
+            // built from a runtime index on both sides, as CodecSlot does
+            CodecVariant variant;
+            ProcessorFactory::create(variant, codec);
+
+            std::visit([&](auto& processor)
+            {
+                if constexpr (! std::is_same_v<std::decay_t<decltype(processor)>, std::monostate>)
+                {
+                    processor.prepare(spec);
+                    processor.setParameters(params);
+                }
+            }, variant);
+
+            auto virtualCodec = createVirtual(codec);
+            virtualCodec->prepare(spec);
+            virtualCodec->setParameters(params);
+
+            double variantTime = time(variant, blockSize, numBlocks, params);
+            double virtualTime = time(*virtualCodec, blockSize, numBlocks, params);
+
+            std::printf("%-10s %6d %14.1f %14.1f %8.3f\n", names[codec], blockSize, variantTime, virtualTime, virtualTime / variantTime);
+        }
+    }
+
+    return 0;
+}
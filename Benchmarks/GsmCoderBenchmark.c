@@ -0,0 +1,405 @@
+/*
+ *  Times Gsm_Coder and Gsm_Decoder per 160 sample frame, single stream,
+ *  the coder's stages one at a time on recorded inputs, gsm_transcode
+ *  against gsm_encode plus gsm_decode, and gsm_transcode_multi against
+ *  one gsm_transcode per stream.
+ *
+ *  Built once per variant of the library: rstc_gsm, with the inline
+ *  arithmetic from private.h and the SIMD kernels; GSM_OUT_OF_LINE, which
+ *  calls the add.c functions instead; GSM_NO_SIMD, the reference
+ *  scalar loops; and GSM_NO_STDINT, with longword a long again.  Each
+ *  pair prints the before/after of one change.  The checksums must match
+ *  across all of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "private.h"
+#include "gsm.h"
+
+#ifndef	RSTC_GSM_BUILD
+#define	RSTC_GSM_BUILD	"inline"
+#endif
+
+#define	NUM_FRAMES	4000
+#define	NUM_RUNS	7
+
+/*  frames per stream in the multi-stream runs  */
+#define	MULTI_FRAMES	1000
+
+static word	input[NUM_FRAMES][160];
+static word	output[NUM_FRAMES][160];
+static struct gsm_parameters	coded[NUM_FRAMES];
+
+static word	packed_output[NUM_FRAMES][160];		/* gsm_encode, gsm_decode */
+static word	transcoded[NUM_FRAMES][160];		/* gsm_transcode */
+
+static word	single_output[GSM_MAX_STREAMS][MULTI_FRAMES][160];
+static word	multi_output[GSM_MAX_STREAMS][MULTI_FRAMES][160];
+
+/*  each stage's input, as Gsm_Coder hands it over  */
+static word	lpc_input[NUM_FRAMES][160];
+static word	ltp_input[NUM_FRAMES][160];		/* short term residual */
+static word	ltp_history[NUM_FRAMES][4][120];	/* dp[-120..-1] */
+static word	rpe_input[NUM_FRAMES][4][50];		/* e[-5..44] */
+
+/*  each stage's output, from the stage run on its own  */
+static struct gsm_parameters	staged[NUM_FRAMES];
+
+static double seconds(void)
+{
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/*  Voiced-ish: two swept partials under a slow envelope, plus noise  */
+static void make_input(void)
+{
+	unsigned	seed = 1;
+	double		phase = 0.0, phase2 = 0.0;
+	int		frame, k;
+
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+		for (k = 0; k < 160; k++) {
+			int	n = frame * 160 + k;
+			double	v;
+
+			seed = seed * 1103515245u + 12345u;
+			v = 9000.0 * sin(phase) * (0.6 + 0.4 * sin(n * 0.0007))
+			  + 5000.0 * sin(phase2)
+			  + (double)((int)((seed >> 8) & 0xfff) - 2048);
+			phase  += 0.05 + 0.04 * sin(n * 0.0003);
+			phase2 += 0.31;
+
+			/* 13 bit, left justified */
+			input[frame][k] = (word)((int)v & ~7);
+		}
+}
+
+static double time_coder(void)
+{
+	struct gsm_state	* S = gsm_create();
+	word			s[160];
+	double			start;
+	int			frame, k;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		struct gsm_parameters	* p = coded + frame;
+
+		/* Gsm_Coder preprocesses in place */
+		for (k = 0; k < 160; k++) s[k] = input[frame][k];
+		Gsm_Coder(S, s, p->LARc, p->Nc, p->bc, p->Mc, p->xmaxc, p->xMc);
+	}
+	start = seconds() - start;
+
+	gsm_destroy(S);
+	return start;
+}
+
+/*  the public calls GSMProcessor used to make, packing every frame  */
+static double time_encode_decode(void)
+{
+	gsm		e = gsm_create(), d = gsm_create();
+	gsm_frame	frame_bytes;
+	double		start;
+	int		frame;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		gsm_encode(e, input[frame], frame_bytes);
+		gsm_decode(d, frame_bytes, packed_output[frame]);
+	}
+	start = seconds() - start;
+
+	gsm_destroy(e);
+	gsm_destroy(d);
+	return start;
+}
+
+static double time_transcode(void)
+{
+	gsm		e = gsm_create(), d = gsm_create();
+	double		start;
+	int		frame;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+		gsm_transcode(e, d, input[frame], transcoded[frame]);
+	start = seconds() - start;
+
+	gsm_destroy(e);
+	gsm_destroy(d);
+	return start;
+}
+
+/*
+ *  n streams, each starting at a different point in the corpus, through
+ *  one gsm_transcode per stream or one gsm_transcode_multi per frame
+ */
+static double time_streams(int n, int multi)
+{
+	gsm		e[GSM_MAX_STREAMS], d[GSM_MAX_STREAMS];
+	gsm_signal	* source[GSM_MAX_STREAMS], * target[GSM_MAX_STREAMS];
+	double		start;
+	int		frame, i;
+
+	for (i = 0; i < n; i++) {
+		e[i] = gsm_create();
+		d[i] = gsm_create();
+	}
+
+	start = seconds();
+	for (frame = 0; frame < MULTI_FRAMES; frame++) {
+		for (i = 0; i < n; i++) {
+			source[i] = input[(frame + i * (NUM_FRAMES / GSM_MAX_STREAMS)) % NUM_FRAMES];
+			target[i] = multi ? multi_output[i][frame] : single_output[i][frame];
+		}
+
+		if (multi)
+			gsm_transcode_multi(n, e, d, source, target);
+		else
+			for (i = 0; i < n; i++)
+				gsm_transcode(e[i], d[i], source[i], target[i]);
+	}
+	start = seconds() - start;
+
+	for (i = 0; i < n; i++) {
+		gsm_destroy(e[i]);
+		gsm_destroy(d[i]);
+	}
+	return start;
+}
+
+/*
+ *  Gsm_Coder with each stage's input kept.  Gsm_LPC_Analysis scales its
+ *  input in place, so the stages can't be rerun on the coder's buffers.
+ */
+static void record_stages(void)
+{
+	struct gsm_state	* S = gsm_create();
+	word			s[160], so[160];
+	longword		ltmp;
+	int			frame, j, k;
+
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		struct gsm_parameters	* p = staged + frame;
+
+		for (k = 0; k < 160; k++) s[k] = input[frame][k];
+		Gsm_Preprocess(S, s, so);
+
+		for (k = 0; k < 160; k++) lpc_input[frame][k] = so[k];
+		Gsm_LPC_Analysis(S, so, p->LARc);
+		Gsm_Short_Term_Analysis_Filter(S, p->LARc, so);
+
+		for (k = 0; k < 160; k++) ltp_input[frame][k] = so[k];
+
+		/* code.c's Coder_subsegments */
+		for (j = 0; j < 4; j++) {
+			word	* dp = S->dp0 + 120 + j * 40;
+
+			for (k = 0; k < 120; k++) ltp_history[frame][j][k] = dp[k - 120];
+
+			Gsm_Long_Term_Predictor(S, so + j * 40, dp, S->e + 5, dp,
+				p->Nc + j, p->bc + j);
+
+			for (k = 0; k < 50; k++) rpe_input[frame][j][k] = S->e[k];
+			Gsm_RPE_Encoding(S, S->e + 5,
+				p->xmaxc + j, p->Mc + j, p->xMc + j * 13);
+
+			for (k = 0; k < 40; k++) dp[k] = GSM_ADD(S->e[5 + k], dp[k]);
+		}
+		memcpy(S->dp0, S->dp0 + 160, 120 * sizeof(*S->dp0));
+	}
+
+	gsm_destroy(S);
+}
+
+/*  Gsm_LPC_Analysis: the autocorrelation, Schur recursion and LAR coding  */
+static double time_lpc(void)
+{
+	struct gsm_state	* S = gsm_create();
+	word			s[160];
+	double			start;
+	int			frame, k;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		for (k = 0; k < 160; k++) s[k] = lpc_input[frame][k];
+		Gsm_LPC_Analysis(S, s, staged[frame].LARc);
+	}
+	start = seconds() - start;
+
+	gsm_destroy(S);
+	return start;
+}
+
+/*  Gsm_Long_Term_Predictor, four times a frame: the lag search and gain  */
+static double time_ltp(void)
+{
+	struct gsm_state	* S = gsm_create();
+	word			dp[160], e[40];
+	double			start;
+	int			frame, j, k;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+		for (j = 0; j < 4; j++) {
+			for (k = 0; k < 120; k++) dp[k] = ltp_history[frame][j][k];
+			Gsm_Long_Term_Predictor(S, ltp_input[frame] + j * 40,
+				dp + 120, e, dp + 120,
+				staged[frame].Nc + j, staged[frame].bc + j);
+		}
+	start = seconds() - start;
+
+	gsm_destroy(S);
+	return start;
+}
+
+/*  Gsm_RPE_Encoding, four times a frame: weighting filter, grid selection, APCM  */
+static double time_rpe(void)
+{
+	struct gsm_state	* S = gsm_create();
+	word			e[50];
+	double			start;
+	int			frame, j, k;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+		for (j = 0; j < 4; j++) {
+			struct gsm_parameters	* p = staged + frame;
+
+			for (k = 0; k < 50; k++) e[k] = rpe_input[frame][j][k];
+			Gsm_RPE_Encoding(S, e + 5, p->xmaxc + j, p->Mc + j, p->xMc + j * 13);
+		}
+	start = seconds() - start;
+
+	gsm_destroy(S);
+	return start;
+}
+
+static unsigned long checksum_words(const word * w, int n, unsigned long sum)
+{
+	while (n--) sum = sum * 31 + (unsigned short)*w++;
+	return sum;
+}
+
+static double time_decoder(void)
+{
+	struct gsm_state	* S = gsm_create();
+	double			start;
+	int			frame;
+
+	start = seconds();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		struct gsm_parameters	* p = coded + frame;
+
+		Gsm_Decoder(S, p->LARc, p->Nc, p->bc, p->Mc, p->xmaxc, p->xMc,
+			output[frame]);
+	}
+	start = seconds() - start;
+
+	gsm_destroy(S);
+	return start;
+}
+
+int main(void)
+{
+	double		coder = 0.0, decoder = 0.0, lpc = 0.0, ltp = 0.0, rpe = 0.0;
+	double		packed = 0.0, transcode = 0.0;
+	double		single[GSM_MAX_STREAMS + 1], multi[GSM_MAX_STREAMS + 1];
+	unsigned long	checksum = 0, larc = 0, lag_gain = 0, pulses = 0;
+	int		run, frame, n;
+
+	make_input();
+	record_stages();
+
+	for (run = 0; run < NUM_RUNS; run++) {
+		double	c = time_coder();
+		double	d = time_decoder();
+		double	l = time_lpc();
+		double	t = time_ltp();
+		double	r = time_rpe();
+
+		if (run == 0 || c < coder)   coder = c;
+		if (run == 0 || d < decoder) decoder = d;
+		if (run == 0 || l < lpc)     lpc = l;
+		if (run == 0 || t < ltp)     ltp = t;
+		if (run == 0 || r < rpe)     rpe = r;
+
+		c = time_encode_decode();
+		d = time_transcode();
+
+		if (run == 0 || c < packed)    packed = c;
+		if (run == 0 || d < transcode) transcode = d;
+
+		for (n = 1; n <= GSM_MAX_STREAMS; n *= 2) {
+			c = time_streams(n, 0);
+			d = time_streams(n, 1);
+
+			if (run == 0 || c < single[n]) single[n] = c;
+			if (run == 0 || d < multi[n])  multi[n] = d;
+		}
+	}
+
+	/* skipping the packing must not change a sample */
+	if (memcmp(packed_output, transcoded, sizeof(transcoded))) {
+		fprintf(stderr, "gsm_transcode differs from gsm_encode + gsm_decode\n");
+		return 1;
+	}
+	if (memcmp(single_output, multi_output, sizeof(multi_output))) {
+		fprintf(stderr, "gsm_transcode_multi differs from gsm_transcode\n");
+		return 1;
+	}
+
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		checksum = checksum_words(output[frame], 160, checksum);
+		larc     = checksum_words(coded[frame].LARc, 8, larc);
+		lag_gain = checksum_words(coded[frame].Nc, 4, lag_gain);
+		lag_gain = checksum_words(coded[frame].bc, 4, lag_gain);
+		pulses   = checksum_words(coded[frame].Mc, 4, pulses);
+		pulses   = checksum_words(coded[frame].xmaxc, 4, pulses);
+		pulses   = checksum_words(coded[frame].xMc, 13 * 4, pulses);
+
+		/* the stage on its own must agree with the whole coder */
+		if (memcmp(staged[frame].LARc, coded[frame].LARc, sizeof(coded[frame].LARc))) {
+			fprintf(stderr, "frame %d: Gsm_LPC_Analysis differs from Gsm_Coder\n", frame);
+			return 1;
+		}
+		if (memcmp(staged[frame].Nc, coded[frame].Nc, sizeof(coded[frame].Nc))
+		 || memcmp(staged[frame].bc, coded[frame].bc, sizeof(coded[frame].bc))) {
+			fprintf(stderr, "frame %d: Gsm_Long_Term_Predictor differs from Gsm_Coder\n", frame);
+			return 1;
+		}
+		if (memcmp(staged[frame].Mc, coded[frame].Mc, sizeof(coded[frame].Mc))
+		 || memcmp(staged[frame].xmaxc, coded[frame].xmaxc, sizeof(coded[frame].xmaxc))
+		 || memcmp(staged[frame].xMc, coded[frame].xMc, sizeof(coded[frame].xMc))) {
+			fprintf(stderr, "frame %d: Gsm_RPE_Encoding differs from Gsm_Coder\n", frame);
+			return 1;
+		}
+	}
+
+	printf("%s build, %d frames, best of %d runs\n", RSTC_GSM_BUILD, NUM_FRAMES, NUM_RUNS);
+	printf("  %-24s %6.2f us/frame\n", "Gsm_Coder", coder / NUM_FRAMES * 1e6);
+	printf("  %-24s %6.2f us/frame  decoded checksum %08lx\n", "Gsm_Decoder",
+		decoder / NUM_FRAMES * 1e6, checksum & 0xffffffffUL);
+	printf("  %-24s %6.2f us/frame  LARc checksum %08lx\n", "Gsm_LPC_Analysis",
+		lpc / NUM_FRAMES * 1e6, larc & 0xffffffffUL);
+	printf("  %-24s %6.2f us/frame  Nc/bc checksum %08lx\n", "Gsm_Long_Term_Predictor",
+		ltp / NUM_FRAMES * 1e6, lag_gain & 0xffffffffUL);
+	printf("  %-24s %6.2f us/frame  RPE checksum %08lx\n", "Gsm_RPE_Encoding",
+		rpe / NUM_FRAMES * 1e6, pulses & 0xffffffffUL);
+	printf("  %-24s %6.2f us/frame\n", "gsm_encode + gsm_decode", packed / NUM_FRAMES * 1e6);
+	printf("  %-24s %6.2f us/frame\n", "gsm_transcode", transcode / NUM_FRAMES * 1e6);
+
+	printf("  %-24s %14s %20s\n", "streams, us/stream/frame", "gsm_transcode", "gsm_transcode_multi");
+	for (n = 1; n <= GSM_MAX_STREAMS; n *= 2)
+		printf("  %24d %14.2f %20.2f\n", n,
+			single[n] / ((double)n * MULTI_FRAMES) * 1e6,
+			multi[n]  / ((double)n * MULTI_FRAMES) * 1e6);
+
+	return 0;
+}
@@ -0,0 +1,16 @@
+#include "AllocationGuard.h"
+
+#if RSTC_ALLOCATION_GUARD
+
+namespace
+{
+    thread_local int guardDepth = 0;
+}
+
+ScopedAllocationGuard::ScopedAllocationGuard() noexcept { ++guardDepth; }
+
+ScopedAllocationGuard::~ScopedAllocationGuard() noexcept { --guardDepth; }
+
+bool ScopedAllocationGuard::isActive() noexcept { return guardDepth > 0; }
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Marks code that runs on the audio thread. While one of these is alive, any
+    heap allocation or release made by the same thread counts as a real-time
+    violation.
+
+    Seeing those allocations means replacing the global operator new/delete,
+    which a plugin must not do to its host, so only the test targets build the
+    guard in: they define RSTC_ALLOCATION_GUARD=1 and link the replacements in
+    Tests/AllocationHooks.cpp. Everywhere else the guard compiles away.
+*/
+class ScopedAllocationGuard
+{
+public:
+   #if RSTC_ALLOCATION_GUARD
+    ScopedAllocationGuard() noexcept;
+    ~ScopedAllocationGuard() noexcept;
+
+    // true while a guard is alive on the calling thread
+    static bool isActive() noexcept;
+   #else
+    ScopedAllocationGuard() noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedAllocationGuard)
+};
@@ -0,0 +1,245 @@
+#include "CodecSlot.h"
+#include "AllocationGuard.h"
+
+CodecSlot::CodecSlot() = default;
+
+CodecSlot::~CodecSlot()
+{
+    releaseAll();
+}
+
+void CodecSlot::prepare(const juce::dsp::ProcessSpec& spec, int codec, const CodecProcessorParameters& params)
+{
+    // nothing is running on the audio thread here, so every instance can go
+    releaseAll();
+
+    processSpec = spec;
+    requestedCodec = codec;
+    active = build(codec, params);
+    latencySamples.store(getLatencySamples(active));
+
+    fadeBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    setCrossfadeLength(crossfadeSeconds);
+}
+
+void CodecSlot::setCrossfadeLength(double seconds)
+{
+    crossfadeSeconds = seconds;
+    crossfadeLength.store(juce::roundToInt(seconds * processSpec.sampleRate));
+}
+
+void CodecSlot::requestCodec(int codec, const CodecProcessorParameters& params)
+{
+    // not prepared yet, or nothing to do
+    if (processSpec.sampleRate <= 0.0 || codec == requestedCodec)
+        return;
+
+    requestedCodec = codec;
+
+    // if the audio thread never picked up the previous request, it's still ours
+    delete pending.exchange(build(codec, params));
+}
+
+void CodecSlot::collectGarbage()
+{
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToRead(retiredFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        delete std::exchange(retired[start1 + i], nullptr);
+
+    for (int i = 0; i < size2; ++i)
+        delete std::exchange(retired[start2 + i], nullptr);
+
+    retiredFifo.finishedRead(size1 + size2);
+}
+
+void CodecSlot::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params)
+{
+    // the test builds count any allocation a processor makes on the audio thread
+    ScopedAllocationGuard allocationGuard;
+
+    int numSamples = buffer.getNumSamples();
+
+    // every processor sizes its buffers to maximumBlockSize, but hosts may send more
+    int chunkSize = processSpec.maximumBlockSize > 0 ? static_cast<int>(processSpec.maximumBlockSize) : numSamples;
+
+    if (numSamples <= chunkSize)
+    {
+        processChunk(buffer, midiMessages, params);
+        return;
+    }
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, juce::jmin(chunkSize, numSamples - start));
+        processChunk(chunk, midiMessages, params);
+    }
+}
+
+void CodecSlot::processChunk(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params)
+{
+    int numSamples = buffer.getNumSamples();
+    int numChannels = juce::jmin(buffer.getNumChannels(), fadeBuffer.getNumChannels());
+
+    // the outgoing processor has finished fading; hand it back when there's room
+    if (outgoing != nullptr && fadePosition >= fadeLength && retire(outgoing))
+        outgoing = nullptr;
+
+    // only swap when the old instance can be handed back; otherwise try next block
+    if (pending.load(std::memory_order_relaxed) != nullptr && retiredFifo.getFreeSpace() > 0)
+    {
+        if (auto* incoming = pending.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            // a fade is already running: drop its tail and fade out the current processor
+            if (outgoing != nullptr)
+                retire(outgoing);
+
+            outgoing = active;
+            active = incoming;
+
+            fadePosition = 0;
+            fadeLength = crossfadeLength.load(std::memory_order_relaxed);
+        }
+    }
+
+    jassert (numSamples <= fadeBuffer.getNumSamples());
+
+    bool fading = outgoing != nullptr && fadePosition < fadeLength;
+
+    // outgoing processor runs on a copy of the input
+    if (fading)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            fadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+        juce::AudioBuffer<float> fadeBlock(fadeBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+        process(outgoing, fadeBlock, midiMessages, params);
+    }
+
+    process(active, buffer, midiMessages, params);
+    latencySamples.store(getLatencySamples(active), std::memory_order_relaxed);
+
+    // linear crossfade from the outgoing to the incoming processor
+    if (fading)
+    {
+        int fadeSamples = juce::jmin(numSamples, fadeLength - fadePosition);
+        float gainStart = static_cast<float>(fadePosition) / static_cast<float>(fadeLength);
+        float gainEnd = static_cast<float>(fadePosition + fadeSamples) / static_cast<float>(fadeLength);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            buffer.applyGainRamp(channel, 0, fadeSamples, gainStart, gainEnd);
+            buffer.addFromWithRamp(channel, 0, fadeBuffer.getReadPointer(channel), fadeSamples, 1.0f - gainStart, 1.0f - gainEnd);
+        }
+
+        fadePosition += fadeSamples;
+    }
+
+    if (outgoing != nullptr && fadePosition >= fadeLength && retire(outgoing))
+        outgoing = nullptr;
+}
+
+void CodecSlot::process(Instance* instance, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params)
+{
+    if (instance == nullptr)
+        return;
+
+    std::visit([&](auto& processor)
+    {
+        // "None" has no processor and passes audio through
+        if constexpr (! std::is_same_v<std::decay_t<decltype(processor)>, std::monostate>)
+        {
+            updateParameters(processor, params);
+
+            processor.processBlock(buffer, midiMessages);
+        }
+    }, instance->processor);
+}
+
+bool CodecSlot::processFused(CodecSlot& next, juce::AudioBuffer<float>& buffer, const CodecProcessorParameters& params)
+{
+    // the resamplers only copy at the host rate; any other factor, or a codec switch, runs unfused
+    if (params.downsampling != 1 || ! isSteady() || ! next.isSteady())
+        return false;
+
+    ScopedAllocationGuard allocationGuard;
+
+    return std::visit([&](auto& first, auto& second)
+    {
+        if constexpr (CompanderChain::canFuse<std::decay_t<decltype(first)>, std::decay_t<decltype(second)>>)
+        {
+            // keep both processors current for when the chain splits again
+            updateParameters(first, params);
+            next.updateParameters(second, params);
+
+            CompanderChain::process(first, second, buffer);
+
+            latencySamples.store(first.getLatencySamples(), std::memory_order_relaxed);
+            next.latencySamples.store(second.getLatencySamples(), std::memory_order_relaxed);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }, active->processor, next.active->processor);
+}
+
+bool CodecSlot::retire(Instance* instance) noexcept
+{
+    if (retiredFifo.getFreeSpace() == 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToWrite(1, start1, size1, start2, size2);
+    retired[size1 > 0 ? start1 : start2] = instance;
+    retiredFifo.finishedWrite(1);
+
+    return true;
+}
+
+int CodecSlot::getLatencySamples(const Instance* instance) noexcept
+{
+    if (instance == nullptr)
+        return 0;
+
+    return std::visit([](const auto& processor)
+    {
+        if constexpr (std::is_same_v<std::decay_t<decltype(processor)>, std::monostate>)
+            return 0;
+        else
+            return processor.getLatencySamples();
+    }, instance->processor);
+}
+
+CodecSlot::Instance* CodecSlot::build(int codec, const CodecProcessorParameters& params)
+{
+    auto instance = std::make_unique<Instance>();
+    instance->codec = codec;
+    ProcessorFactory::create(instance->processor, codec);
+
+    // apply the current parameters here so the first block doesn't redesign filters
+    std::visit([&](auto& processor)
+    {
+        if constexpr (! std::is_same_v<std::decay_t<decltype(processor)>, std::monostate>)
+        {
+            processor.prepare(processSpec);
+            processor.setParameters(params);
+        }
+    }, instance->processor);
+
+    return instance.release();
+}
+
+void CodecSlot::releaseAll()
+{
+    collectGarbage();
+
+    delete pending.exchange(nullptr);
+    delete std::exchange(active, nullptr);
+    delete std::exchange(outgoing, nullptr);
+
+    fadePosition = 0;
+    fadeLength = 0;
+}
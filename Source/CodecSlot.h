@@ -0,0 +1,138 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <variant>
+
+#include "CompanderProcessor.h"
+#include "GsmProcessor.h"
+#include "VoxProcessor.h"
+#include "Utilities.h"
+
+// alternative index == codec type; std::monostate is "None"
+using CodecVariant = std::variant<std::monostate,
+                                  GSMProcessor,
+                                  MuLawProcessor,
+                                  ALawProcessor,
+                                  VoxProcessor>;
+
+struct ProcessorFactory
+{
+    template <std::size_t type = 1>
+    static void create(CodecVariant& processor, int codec)
+    {
+        if constexpr (type < std::variant_size_v<CodecVariant>)
+        {
+            if (codec == static_cast<int>(type))
+                processor.emplace<type>();
+            else
+                create<type + 1>(processor, codec);
+        }
+        else
+        {
+            processor.emplace<std::monostate>();
+        }
+    }
+};
+
+//==============================================================================
+/**
+    One codec slot of the plugin.
+
+    Processors are built and prepared on the message thread, then handed to the
+    audio thread through an atomic pointer. The audio thread hands replaced
+    instances back through a lock-free FIFO, so they are also freed on the
+    message thread and processBlock never allocates or deletes a processor.
+
+    When a new processor arrives, the old one keeps running on a preallocated
+    copy of the input and the two are crossfaded before the old one is retired.
+*/
+class CodecSlot
+{
+public:
+    CodecSlot();
+
+    ~CodecSlot();
+
+    // message thread; audio must be stopped
+    void prepare(const juce::dsp::ProcessSpec& spec, int codec, const CodecProcessorParameters& params);
+
+    // message thread, or the audio thread when rendering offline; builds and
+    // publishes a new processor if codec changed. Calls must not overlap
+    void requestCodec(int codec, const CodecProcessorParameters& params);
+
+    // same thread rules as requestCodec; frees instances the audio thread has retired
+    void collectGarbage();
+
+    // message thread; 0 switches codecs instantly
+    void setCrossfadeLength(double seconds);
+
+    // audio thread; picks up a pending processor, if any, and runs the slot. Blocks
+    // longer than maximumBlockSize run in pieces
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params);
+
+    // audio thread; runs this slot and next as one when CompanderChain can fuse them. Returns
+    // false without touching anything if not, and the slots must then run on their own
+    bool processFused(CodecSlot& next, juce::AudioBuffer<float>& buffer, const CodecProcessorParameters& params);
+
+    // any thread; host samples of delay through the processor the audio thread is running
+    int getLatencySamples() const noexcept { return latencySamples.load(std::memory_order_relaxed); }
+
+private:
+    struct Instance
+    {
+        int codec = 0;
+        CodecVariant processor;
+    };
+
+    // at most maximumBlockSize samples
+    void processChunk(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params);
+
+    void process(Instance* instance, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, const CodecProcessorParameters& params);
+
+    template <typename Processor>
+    void updateParameters(Processor& processor, const CodecProcessorParameters& params)
+    {
+        processorParameters = processor.getParameters();
+        processorParameters.downsampling = params.downsampling;
+        processorParameters.bitrate = params.bitrate;
+        processorParameters.companderBits = params.companderBits;
+
+        processor.setParameters(processorParameters);
+    }
+
+    // no codec switch pending or fading
+    bool isSteady() const noexcept { return active != nullptr && outgoing == nullptr && pending.load(std::memory_order_relaxed) == nullptr; }
+
+    bool retire(Instance* instance) noexcept;
+
+    static int getLatencySamples(const Instance* instance) noexcept;
+
+    Instance* build(int codec, const CodecProcessorParameters& params);
+
+    void releaseAll();
+
+    juce::dsp::ProcessSpec processSpec { 0.0, 0, 0 };
+    int requestedCodec = -1;
+
+    std::atomic<Instance*> pending { nullptr };
+    Instance* active = nullptr;
+    Instance* outgoing = nullptr;
+
+    CodecProcessorParameters processorParameters;
+
+    std::atomic<int> latencySamples { 0 };
+
+    double crossfadeSeconds = 0.05;
+    std::atomic<int> crossfadeLength { 0 };
+    int fadeLength = 0;
+    int fadePosition = 0;
+    juce::AudioBuffer<float> fadeBuffer;
+
+    static constexpr int retiredCapacity = 8;
+    juce::AbstractFifo retiredFifo { retiredCapacity };
+    std::array<Instance*, retiredCapacity> retired {};
+
+    JUCE_DECLARE_NON_COPYABLE (CodecSlot)
+};
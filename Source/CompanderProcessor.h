@@ -1,7 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <type_traits>
+#include "ResamplingEngine.h"
 #include "Utilities.h"
 
 //=======================================================================
@@ -11,25 +15,59 @@ class MuLawProcessor : public CodecProcessorBase
 public:
     MuLawProcessor();
     
-    ~MuLawProcessor() override;
+    ~MuLawProcessor();
     
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     
-    void reset() override;
+    void reset();
     
-    CodecProcessorParameters& getParameters() override;
+    CodecProcessorParameters& getParameters();
     
-    void setParameters(const CodecProcessorParameters& params) override;
+    void setParameters(const CodecProcessorParameters& params);
+    
+    // host samples the output lags the input by
+    int getLatencySamples() const noexcept;
     
 private:
-    unsigned char Lin2MuLaw(int16_t pcm_val);
+    // quantises the decimated block in place
+    void compand(float* lowRate, int numSamples) const noexcept;
+    
+    // host samples per pass through the stages; keeps each pass's data in cache
+    static constexpr size_t subBlockSize = 256;
+    
+    static constexpr unsigned char Lin2MuLaw(int16_t pcm_val);
+    
+    static constexpr short MuLaw2Lin(uint8_t u_val);
+    
+    // picks the decode table for the bit depth; only swaps a pointer
+    void updateBitDepth() noexcept;
+    
+    // the 8-bit code of every 16-bit x, indexed by the sample's bit pattern
+    static constexpr std::array<uint8_t, 65536> makeEncodeTable();
+    
+    // decodes only the top numBits bits of a code
+    static constexpr std::array<int16_t, 256> makeDecodeTable(int numBits);
+    
+    static constexpr int minBits = 3;
+    static constexpr int maxBits = 8;
+    
+    // inline constexpr, defined below the class once the functions that build them are complete;
+    // the compiler fills them in, so there is nothing to run at load time
+    static const std::array<uint8_t, 65536> encodeTable;
+    
+    // indexed by numBits - minBits
+    static const std::array<std::array<int16_t, 256>, maxBits - minBits + 1> decodeTables;
+    
+    const int16_t* decodeTable = decodeTables.back().data();
+    int numBits = maxBits;
     
-    short MuLaw2Lin(uint8_t u_val);
+    // reads the tables and outScale to fuse adjacent slots
+    friend class CompanderChain;
     
-    const int bias = 0x84;
-    const int clip = 32635;
+    static constexpr int bias = 0x84;
+    static constexpr int clip = 32635;
     
     constexpr static char MuLawCompressTable[256]
     {
@@ -91,16 +129,77 @@ private:
     
     float outScale = 1.0f/32767.0f;
     
-    float sampleRate = 44100;
-    int resamplingFilterOrder = 8;
-    std::vector<int> downsamplingCounter { 0, 0 };
-    std::vector<float> downsamplingInput { 0.0f, 0.0f };
+    ResamplingEngine resampler;
+};
+
+constexpr unsigned char MuLawProcessor::Lin2MuLaw(int16_t pcm_val)
+{
+    int sign = (pcm_val >> 8) & 0x80;
+    if (sign)
+        pcm_val = static_cast<int16_t>(-pcm_val);
+    if (pcm_val > clip)
+        pcm_val = clip;
+    pcm_val = static_cast<int16_t>(pcm_val + bias);
+    int exponent = static_cast<int>(MuLawCompressTable[(pcm_val >> 7) & 0xff]);
+    int mantissa = (pcm_val >> (exponent + 3)) & 0x0f;
+    int compressedByte = ~(sign | (exponent << 4) | mantissa);
+    
+    return static_cast<unsigned char>(compressedByte);
+}
+
+constexpr short MuLawProcessor::MuLaw2Lin(uint8_t u_val)
+{
+    return MuLawDecompressTable[u_val];
+}
+
+constexpr std::array<uint8_t, 65536> MuLawProcessor::makeEncodeTable()
+{
+    std::array<uint8_t, 65536> table {};
+    
+    for (int i = 0; i < 65536; ++i)
+        table[static_cast<size_t>(i)] = Lin2MuLaw(static_cast<int16_t>(i));
+    
+    return table;
+}
+
+constexpr std::array<int16_t, 256> MuLawProcessor::makeDecodeTable(int numBits)
+{
+    // codes that share their top numBits bits become one step, decoded to the middle of the
+    // values they covered; at 8 bits this is the plain decode table
+    int shift = 8 - numBits;
+    std::array<int, 256> low {}, high {};
+    
+    for (int group = 0; group < (256 >> shift); ++group)
+    {
+        low[static_cast<size_t>(group)] = 32767;
+        high[static_cast<size_t>(group)] = -32768;
+    }
+    
+    for (int code = 0; code < 256; ++code)
+    {
+        auto group = static_cast<size_t>(code >> shift);
+        int value = MuLaw2Lin(static_cast<uint8_t>(code));
+        low[group] = std::min(low[group], value);
+        high[group] = std::max(high[group], value);
+    }
     
-    using IIR = juce::dsp::IIR::Filter<float>;
-    std::vector<std::vector<IIR>> preFilters;
-    std::vector<std::vector<IIR>> postFilters;
+    std::array<int16_t, 256> table {};
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> filterCoefficientsArray;
+    for (int code = 0; code < 256; ++code)
+    {
+        auto group = static_cast<size_t>(code >> shift);
+        table[static_cast<size_t>(code)] = static_cast<int16_t>((low[group] + high[group]) / 2);
+    }
+    
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 65536> MuLawProcessor::encodeTable = makeEncodeTable();
+
+inline constexpr std::array<std::array<int16_t, 256>, MuLawProcessor::maxBits - MuLawProcessor::minBits + 1> MuLawProcessor::decodeTables
+{
+    makeDecodeTable(3), makeDecodeTable(4), makeDecodeTable(5),
+    makeDecodeTable(6), makeDecodeTable(7), makeDecodeTable(8)
 };
 
 
@@ -111,24 +210,57 @@ class ALawProcessor : public CodecProcessorBase
 public:
     ALawProcessor();
     
-    ~ALawProcessor() override;
+    ~ALawProcessor();
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void reset();
     
-    void reset() override;
+    CodecProcessorParameters& getParameters();
     
-    CodecProcessorParameters& getParameters() override;
+    void setParameters(const CodecProcessorParameters& params);
     
-    void setParameters(const CodecProcessorParameters& params) override;
+    // host samples the output lags the input by
+    int getLatencySamples() const noexcept;
     
 private:
-    unsigned char Lin2ALaw(int16_t pcm_val);
+    // quantises the decimated block in place
+    void compand(float* lowRate, int numSamples) const noexcept;
     
-    short ALaw2Lin(uint8_t u_val);
+    // host samples per pass through the stages; keeps each pass's data in cache
+    static constexpr size_t subBlockSize = 256;
     
-    const int clip = 32635;
+    static constexpr unsigned char Lin2ALaw(int16_t pcm_val);
+    
+    static constexpr short ALaw2Lin(uint8_t u_val);
+    
+    // picks the decode table for the bit depth; only swaps a pointer
+    void updateBitDepth() noexcept;
+    
+    // the 8-bit code of every 16-bit x, indexed by the sample's bit pattern
+    static constexpr std::array<uint8_t, 65536> makeEncodeTable();
+    
+    // decodes only the top numBits bits of a code
+    static constexpr std::array<int16_t, 256> makeDecodeTable(int numBits);
+    
+    static constexpr int minBits = 3;
+    static constexpr int maxBits = 8;
+    
+    // inline constexpr, defined below the class
+    static const std::array<uint8_t, 65536> encodeTable;
+    
+    // indexed by numBits - minBits
+    static const std::array<std::array<int16_t, 256>, maxBits - minBits + 1> decodeTables;
+    
+    const int16_t* decodeTable = decodeTables.back().data();
+    int numBits = maxBits;
+    
+    // reads the tables and outScale to fuse adjacent slots
+    friend class CompanderChain;
+    
+    static constexpr int clip = 32635;
     constexpr static char ALawCompressTable[128]
     {
         1,1,2,2,3,3,3,3,
@@ -187,16 +319,176 @@ private:
     
     float outScale = 1.0f/32767.0f;
     
-    float sampleRate = 44100;
-    int resamplingFilterOrder = 8;
-    std::vector<int> downsamplingCounter { 0, 0 };
-    std::vector<float> downsamplingInput { 0.0f, 0.0f };
-    
     CodecProcessorParameters parameters;
     
-    using IIR = juce::dsp::IIR::Filter<float>;
-    std::vector<std::vector<IIR>> preFilters;
-    std::vector<std::vector<IIR>> postFilters;
+    ResamplingEngine resampler;
+};
+
+constexpr unsigned char ALawProcessor::Lin2ALaw(int16_t pcm_val)
+{
+    int sign = 0;
+    int exponent = 0;
+    int mantissa = 0;
+    unsigned char compressedByte = 0;
+    
+    sign = ((~pcm_val) >> 8) & 0x80;
+    if (!sign)
+        pcm_val = static_cast<int16_t>(-pcm_val);
+    if (pcm_val > clip)
+        pcm_val = clip;
+    if (pcm_val >= 256)
+    {
+        exponent = static_cast<int>(ALawCompressTable[(pcm_val >> 8) & 0x7f]);
+        mantissa = (pcm_val >> (exponent + 3)) & 0x0f;
+        compressedByte = static_cast<unsigned char>((exponent << 4) | mantissa);
+    }
+    else
+        compressedByte = static_cast<unsigned char>(pcm_val >> 4);
+    
+    compressedByte = static_cast<unsigned char>(compressedByte ^ (sign ^ 0x55));
+    return compressedByte;
+}
+
+constexpr short ALawProcessor::ALaw2Lin(uint8_t a_val)
+{
+    return ALawDecompressTable[a_val];
+}
+
+constexpr std::array<uint8_t, 65536> ALawProcessor::makeEncodeTable()
+{
+    std::array<uint8_t, 65536> table {};
+    
+    for (int i = 0; i < 65536; ++i)
+        table[static_cast<size_t>(i)] = Lin2ALaw(static_cast<int16_t>(i));
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> mFilterCoefficientsArray;
+    return table;
+}
+
+constexpr std::array<int16_t, 256> ALawProcessor::makeDecodeTable(int numBits)
+{
+    // codes that share their top numBits bits become one step, decoded to the middle of the
+    // values they covered; at 8 bits this is the plain decode table
+    int shift = 8 - numBits;
+    std::array<int, 256> low {}, high {};
+    
+    for (int group = 0; group < (256 >> shift); ++group)
+    {
+        low[static_cast<size_t>(group)] = 32767;
+        high[static_cast<size_t>(group)] = -32768;
+    }
+    
+    for (int code = 0; code < 256; ++code)
+    {
+        auto group = static_cast<size_t>(code >> shift);
+        int value = ALaw2Lin(static_cast<uint8_t>(code));
+        low[group] = std::min(low[group], value);
+        high[group] = std::max(high[group], value);
+    }
+    
+    std::array<int16_t, 256> table {};
+    
+    for (int code = 0; code < 256; ++code)
+    {
+        auto group = static_cast<size_t>(code >> shift);
+        table[static_cast<size_t>(code)] = static_cast<int16_t>((low[group] + high[group]) / 2);
+    }
+    
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 65536> ALawProcessor::encodeTable = makeEncodeTable();
+
+inline constexpr std::array<std::array<int16_t, 256>, ALawProcessor::maxBits - ALawProcessor::minBits + 1> ALawProcessor::decodeTables
+{
+    makeDecodeTable(3), makeDecodeTable(4), makeDecodeTable(5),
+    makeDecodeTable(6), makeDecodeTable(7), makeDecodeTable(8)
 };
+
+//=======================================================================
+
+// Two companders in adjacent slots at the host rate, where neither resampler filters, are
+// memoryless together: the second slot's output depends on nothing but the first slot's code.
+// The tables hold that output for every code and bit depth, so the pair costs one lookup.
+class CompanderChain
+{
+public:
+    template <typename First, typename Second>
+    static constexpr bool canFuse = (std::is_same_v<First, MuLawProcessor> || std::is_same_v<First, ALawProcessor>)
+                                 && (std::is_same_v<Second, MuLawProcessor> || std::is_same_v<Second, ALawProcessor>);
+    
+    // audio thread; same output as first.processBlock() then second.processBlock() at the host rate
+    template <typename First, typename Second>
+    static void process(const First& first, const Second& second, juce::AudioBuffer<float>& buffer) noexcept
+    {
+        jassert (first.numBits == second.numBits);
+        
+        const int16_t* table = tablesFor(first, second)[static_cast<size_t>(first.numBits - First::minBits)].data();
+        
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* channelData = buffer.getWritePointer(channel);
+            int numSamples = buffer.getNumSamples();
+            
+            juce::FloatVectorOperations::multiply(channelData, 32767.0f, numSamples);
+            juce::FloatVectorOperations::clip(channelData, channelData, -32767.0f, 32767.0f, numSamples);
+            
+            for (int sample = 0; sample < numSamples; ++sample)
+                channelData[sample] = static_cast<float>(table[First::encodeTable[static_cast<uint16_t>(static_cast<int16_t>(channelData[sample]))]]);
+            
+            juce::FloatVectorOperations::multiply(channelData, second.outScale, numSamples);
+        }
+    }
+    
+private:
+    // indexed by bit depth, then by the first slot's code
+    using Tables = std::array<std::array<int16_t, 256>, MuLawProcessor::maxBits - MuLawProcessor::minBits + 1>;
+    
+    template <typename First, typename Second>
+    static constexpr Tables makeTables();
+    
+    static const Tables& tablesFor(const MuLawProcessor&, const MuLawProcessor&) noexcept { return muLawToMuLaw; }
+    static const Tables& tablesFor(const MuLawProcessor&, const ALawProcessor&) noexcept { return muLawToALaw; }
+    static const Tables& tablesFor(const ALawProcessor&, const MuLawProcessor&) noexcept { return aLawToMuLaw; }
+    static const Tables& tablesFor(const ALawProcessor&, const ALawProcessor&) noexcept { return aLawToALaw; }
+    
+    // inline constexpr, defined below the class
+    static const Tables muLawToMuLaw;
+    static const Tables muLawToALaw;
+    static const Tables aLawToMuLaw;
+    static const Tables aLawToALaw;
+};
+
+template <typename First, typename Second>
+constexpr CompanderChain::Tables CompanderChain::makeTables()
+{
+    Tables tables {};
+    
+    for (int numBits = First::minBits; numBits <= First::maxBits; ++numBits)
+    {
+        auto firstDecode = First::makeDecodeTable(numBits);
+        auto secondDecode = Second::makeDecodeTable(numBits);
+        auto& table = tables[static_cast<size_t>(numBits - First::minBits)];
+        
+        for (int code = 0; code < 256; ++code)
+        {
+            // the first slot's float output, rescaled, clipped and truncated as the second slot does
+            float output = static_cast<float>(firstDecode[static_cast<size_t>(code)]) * (1.0f/32767.0f);
+            auto pcm = static_cast<int16_t>(std::min(32767.0f, std::max(-32767.0f, output * 32767.0f)));
+            
+            uint8_t secondCode = 0;
+            if constexpr (std::is_same_v<Second, MuLawProcessor>)
+                secondCode = MuLawProcessor::Lin2MuLaw(pcm);
+            else
+                secondCode = ALawProcessor::Lin2ALaw(pcm);
+            
+            table[static_cast<size_t>(code)] = secondDecode[secondCode];
+        }
+    }
+    
+    return tables;
+}
+
+inline constexpr CompanderChain::Tables CompanderChain::muLawToMuLaw = makeTables<MuLawProcessor, MuLawProcessor>();
+inline constexpr CompanderChain::Tables CompanderChain::muLawToALaw = makeTables<MuLawProcessor, ALawProcessor>();
+inline constexpr CompanderChain::Tables CompanderChain::aLawToMuLaw = makeTables<ALawProcessor, MuLawProcessor>();
+inline constexpr CompanderChain::Tables CompanderChain::aLawToALaw = makeTables<ALawProcessor, ALawProcessor>();
@@ -10,17 +10,17 @@ class DPCMProcessor : public CodecProcessorBase
 public:
     DPCMProcessor();
     
-    ~DPCMProcessor() override;
+    ~DPCMProcessor();
     
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     
-    void reset() override;
+    void reset();
     
-    CodecProcessorParameters& getParameters() override;
+    CodecProcessorParameters& getParameters();
     
-    void setParameters(const CodecProcessorParameters& params) override;
+    void setParameters(const CodecProcessorParameters& params);
     
 private:
     uint8_t dpcmEncoder(float inVal);
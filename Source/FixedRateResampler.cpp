@@ -0,0 +1,192 @@
+#include "FixedRateResampler.h"
+
+FarrowResampler::FarrowResampler() = default;
+
+FarrowResampler::~FarrowResampler() = default;
+
+void FarrowResampler::prepare(int numChannels, int maxInputBlockSize)
+{
+    buffer.resize(numChannels);
+
+    for (auto& channelBuffer : buffer)
+        channelBuffer.resize(history + maxInputBlockSize);
+
+    position.resize(numChannels);
+
+    reset();
+}
+
+void FarrowResampler::reset()
+{
+    for (auto& channelBuffer : buffer)
+        std::fill(channelBuffer.begin(), channelBuffer.end(), 0.0f);
+
+    // first output sits on the second history sample, so x[-1] exists
+    std::fill(position.begin(), position.end(), 1.0);
+}
+
+void FarrowResampler::setRatio(double inputRate, double outputRate)
+{
+    ratio = inputRate / outputRate;
+}
+
+int FarrowResampler::getNumInputsNeeded(int channel, int numOutput) const noexcept
+{
+    if (numOutput <= 0)
+        return 0;
+
+    // the last output's x[2] has to be the last new input
+    double lastPosition = position[channel] + (numOutput - 1) * ratio;
+    return juce::jmax(0, static_cast<int>(lastPosition) - (history - 3));
+}
+
+int FarrowResampler::process(int channel, const float* input, int numInput, float* output, int maxOutput) noexcept
+{
+    auto& data = buffer[channel];
+    auto& t = position[channel];
+
+    jassert (numInput <= static_cast<int>(data.size()) - history);
+    std::copy(input, input + numInput, data.begin() + history);
+
+    int lastIndex = history + numInput - 3;
+    int numOutput = 0;
+
+    while (numOutput < maxOutput)
+    {
+        int index = static_cast<int>(t);
+        if (index > lastIndex)
+            break;
+
+        float mu = static_cast<float>(t - index);
+        const float* x = data.data() + index;
+
+        // cubic Lagrange through x[-1], x[0], x[1], x[2]
+        float c0 = x[0];
+        float c1 = x[1] - x[-1] * (1.0f / 3.0f) - x[0] * 0.5f - x[2] * (1.0f / 6.0f);
+        float c2 = (x[-1] + x[1]) * 0.5f - x[0];
+        float c3 = (x[2] - x[-1]) * (1.0f / 6.0f) + (x[0] - x[1]) * 0.5f;
+
+        output[numOutput++] = ((c3 * mu + c2) * mu + c1) * mu + c0;
+        t += ratio;
+    }
+
+    std::copy(data.begin() + numInput, data.begin() + numInput + history, data.begin());
+    t -= numInput;
+
+    return numOutput;
+}
+
+//==============================================================================
+FixedRateResampler::FixedRateResampler() = default;
+
+FixedRateResampler::~FixedRateResampler() = default;
+
+void FixedRateResampler::prepare(const juce::dsp::ProcessSpec& spec, double newCodecRate)
+{
+    codecRate = newCodecRate;
+    int numChannels = static_cast<int>(spec.numChannels);
+    int maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+
+    // integer stage lands on the nearest rate at or above the codec rate
+    int factor = juce::jlimit(1, ResamplingEngine::maxFactor, static_cast<int>(spec.sampleRate / codecRate));
+    double intermediateRate = spec.sampleRate / factor;
+
+    integerStage.prepare(spec, factor, juce::jmin(3400.0, intermediateRate * 0.4));
+
+    int maxCodecBlockSize = static_cast<int>(std::ceil(maxBlockSize * juce::jmax(1.0, codecRate / intermediateRate))) + 4;
+
+    downStage.prepare(numChannels, maxBlockSize);
+    downStage.setRatio(intermediateRate, codecRate);
+
+    upStage.prepare(numChannels, maxCodecBlockSize);
+    upStage.setRatio(codecRate, intermediateRate);
+
+    // the down stage runs at the intermediate rate; the up stage and the FIFO at the codec rate
+    double codecLatency = FarrowResampler::getLatencySamples() + fifoLatency;
+    latencySamples = integerStage.getLatencySamples()
+                   + juce::roundToInt(factor * (FarrowResampler::getLatencySamples() + codecLatency * intermediateRate / codecRate));
+
+    codecData.resize(numChannels);
+    fifo.resize(numChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        codecData[channel].resize(maxCodecBlockSize);
+        fifo[channel].resize(2 * maxCodecBlockSize + fifoLatency);
+    }
+
+    numIntermediateSamples.resize(numChannels);
+    numCodecSamples.resize(numChannels);
+    fifoStart.resize(numChannels);
+    fifoSize.resize(numChannels);
+    upStageInput.resize(maxCodecBlockSize);
+
+    reset();
+}
+
+void FixedRateResampler::reset()
+{
+    integerStage.reset();
+    downStage.reset();
+    upStage.reset();
+
+    for (auto& channelFifo : fifo)
+        std::fill(channelFifo.begin(), channelFifo.end(), 0.0f);
+
+    std::fill(numIntermediateSamples.begin(), numIntermediateSamples.end(), 0);
+    std::fill(numCodecSamples.begin(), numCodecSamples.end(), 0);
+    std::fill(fifoStart.begin(), fifoStart.end(), 0);
+    std::fill(fifoSize.begin(), fifoSize.end(), fifoLatency);
+}
+
+int FixedRateResampler::decimate(int channel, const float* input, int numSamples)
+{
+    int numIntermediate = integerStage.decimate(channel, input, numSamples);
+    numIntermediateSamples[channel] = numIntermediate;
+
+    auto& output = codecData[channel];
+    numCodecSamples[channel] = downStage.process(channel, integerStage.getLowRateData(channel), numIntermediate,
+                                                 output.data(), static_cast<int>(output.size()));
+    return numCodecSamples[channel];
+}
+
+void FixedRateResampler::interpolate(int channel, float* output, int numSamples)
+{
+    auto& channelFifo = fifo[channel];
+    auto& start = fifoStart[channel];
+    auto& size = fifoSize[channel];
+    int capacity = static_cast<int>(channelFifo.size());
+
+    // queue this block's codec output
+    for (int sample = 0; sample < numCodecSamples[channel]; ++sample)
+    {
+        jassert (size < capacity);
+        channelFifo[(start + size) % capacity] = codecData[channel][sample];
+        size = juce::jmin(size + 1, capacity);
+    }
+
+    int numIntermediate = numIntermediateSamples[channel];
+    int numNeeded = juce::jmin(upStage.getNumInputsNeeded(channel, numIntermediate), static_cast<int>(upStageInput.size()));
+
+    for (int sample = 0; sample < numNeeded; ++sample)
+    {
+        // should not underrun; repeat the last sample rather than click if it does
+        jassert (size > 0);
+        if (size > 0)
+        {
+            upStageInput[sample] = channelFifo[start];
+            start = (start + 1) % capacity;
+            --size;
+        }
+        else
+        {
+            upStageInput[sample] = sample > 0 ? upStageInput[sample - 1] : 0.0f;
+        }
+    }
+
+    int numProduced = upStage.process(channel, upStageInput.data(), numNeeded, integerStage.getLowRateData(channel), numIntermediate);
+    jassert (numProduced == numIntermediate);
+    juce::ignoreUnused(numProduced);
+
+    integerStage.interpolate(channel, output, numSamples);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "ResamplingEngine.h"
+
+//==============================================================================
+/**
+    Streaming fractional-ratio resampler using a cubic Lagrange Farrow structure.
+
+    Output positions advance by inputRate / outputRate input samples. The
+    interpolation polynomial is evaluated directly from the four neighbouring
+    inputs, so changing the ratio costs nothing.
+*/
+class FarrowResampler
+{
+public:
+    FarrowResampler();
+
+    ~FarrowResampler();
+
+    void prepare(int numChannels, int maxInputBlockSize);
+
+    void reset();
+
+    void setRatio(double inputRate, double outputRate);
+
+    // inputs process() needs to produce numOutput samples
+    int getNumInputsNeeded(int channel, int numOutput) const noexcept;
+
+    // returns the number of samples written to output, at most maxOutput
+    int process(int channel, const float* input, int numInput, float* output, int maxOutput) noexcept;
+
+    // outputs lag their inputs by this many input samples
+    static constexpr int getLatencySamples() noexcept { return history - 1; }
+
+private:
+    // samples kept from the previous block so every output has its four neighbours
+    static constexpr int history = 4;
+
+    double ratio = 1.0;
+
+    std::vector<std::vector<float>> buffer;
+    std::vector<double> position;
+};
+
+//==============================================================================
+/**
+    Converts between the host rate and a fixed codec rate, e.g. 8 kHz for GSM.
+
+    An integer ResamplingEngine stage brings the host rate down to the nearest
+    rate at or above the codec rate and band-limits to the telephone band; a
+    Farrow stage covers the remaining fraction. On the way back a short FIFO
+    absorbs the +/-1 sample jitter between what the two Farrow stages produce
+    and consume per block.
+
+    Same calling pattern as ResamplingEngine: decimate(), run the codec in place
+    on getLowRateData(), then interpolate().
+*/
+class FixedRateResampler
+{
+public:
+    FixedRateResampler();
+
+    ~FixedRateResampler();
+
+    void prepare(const juce::dsp::ProcessSpec& spec, double newCodecRate);
+
+    void reset();
+
+    // returns the number of codec-rate samples written to getLowRateData(channel)
+    int decimate(int channel, const float* input, int numSamples);
+
+    float* getLowRateData(int channel) noexcept { return codecData[static_cast<size_t>(channel)].data(); }
+
+    void interpolate(int channel, float* output, int numSamples);
+
+    double getCodecRate() const noexcept { return codecRate; }
+
+    // delay of decimate() then interpolate(), in host samples
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+private:
+    double codecRate = 8000.0;
+    int latencySamples = 0;
+
+    ResamplingEngine integerStage;
+    FarrowResampler downStage;
+    FarrowResampler upStage;
+
+    std::vector<std::vector<float>> codecData;
+    std::vector<int> numIntermediateSamples;
+    std::vector<int> numCodecSamples;
+
+    // codec output waiting for the up stage
+    static constexpr int fifoLatency = 4;
+    std::vector<std::vector<float>> fifo;
+    std::vector<int> fifoStart;
+    std::vector<int> fifoSize;
+    std::vector<float> upStageInput;
+};
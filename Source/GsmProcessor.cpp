@@ -7,24 +7,18 @@ GSMProcessor::~GSMProcessor() = default;
 
 void GSMProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    sampleRate = spec.sampleRate;
+    // every channel runs its own codec at the 8 kHz rate GSM 06.10 is defined for
+    resampler.prepare(spec, 8000.0);
     
-    filterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((sampleRate / parameters.downsampling) * 0.4, sampleRate, resamplingFilterOrder);
+    // each decoded sample comes out one frame after it went in
+    frameLatency = juce::roundToInt(frameSize * spec.sampleRate / resampler.getCodecRate());
     
-    preFilters.resize(resamplingFilterOrder / 2);
-    postFilters.resize(resamplingFilterOrder / 2);
+    channels.resize(spec.numChannels);
     
-    for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
+    for (auto& channel : channels)
     {
-        // prepare each pre-filter
-        preFilters[filter].reset();
-        preFilters[filter].prepare(spec);
-        preFilters[filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-        
-        // prepare each post-filter
-        postFilters[filter].reset();
-        postFilters[filter].prepare(spec);
-        postFilters[filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
+        channel.encode = {};
+        channel.decode = {};
     }
     
     reset();
@@ -33,117 +27,136 @@ void GSMProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 void GSMProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     int numSamples = buffer.getNumSamples();
-    int numChannels = buffer.getNumChannels();
+    int numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(channels.size()));
+    
+    // ================ pre-filtering block ================
+    int numDecimated = 0;
     
-    juce::AudioBuffer<float> monoBuffer(1, numSamples);
-    monoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-    if (numChannels > 1)
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        monoBuffer.addFrom(0, 0, buffer, 1, 0, numSamples);
-        monoBuffer.applyGain(0.5f);
+        auto* channelData = buffer.getWritePointer(channel);
+        auto& lowCutFilter = channels[channel].lowCutFilter;
+        
+        // low cut filter
+        for (int sample = 0; sample < numSamples; ++sample)
+            channelData[sample] = lowCutFilter.processSample(channelData[sample]);
+        
+        // band-limit and resample to exactly 8 kHz; every channel gets the same count
+        numDecimated = resampler.decimate(channel, channelData, numSamples);
     }
     
-    auto* src = monoBuffer.getWritePointer(0);
-    
-    for (int sample = 0; sample < numSamples; ++sample)
+    // sample and hold below 8 kHz for the downsampling parameter
+    if (parameters.downsampling > 1)
     {
-        // if gsm data variables are valid, process audio
-        if (gsmSignalInput != nullptr && gsmSignal != nullptr && gsmSignalOutput != nullptr)
+        int counter = holdCounter;
+        
+        for (int channel = 0; channel < numChannels; ++channel)
         {
-            // ================ pre-filtering block ================
-            // low cut filter
-            src[sample] = lowCutFilter.processSample(src[sample]);
+            auto* gsmData = resampler.getLowRateData(channel);
+            auto& heldSample = channels[channel].heldSample;
+            counter = holdCounter;
             
-            // pre-filter if downsampling
-            if (parameters.downsampling > 1)
+            for (int sample = 0; sample < numDecimated; ++sample)
             {
-                for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
-                {
-                    src[sample] = preFilters[filter].processSample(src[sample]);
-                    preFilters[filter].snapToZero();
-                }
+                if (counter == 0)
+                    heldSample = gsmData[sample];
+                
+                gsmData[sample] = heldSample;
+                
+                if (++counter >= parameters.downsampling)
+                    counter = 0;
             }
+        }
+        
+        holdCounter = counter;
+    }
+    
+    //================ GSM processing block ================
+    // runs up to the next frame boundary, so each channel's inner loop is branch-free
+    for (int position = 0; position < numDecimated;)
+    {
+        int runLength = juce::jmin(numDecimated - position, frameSize - gsmSignalCounter);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto& state = channels[channel];
+            auto* gsmData = resampler.getLowRateData(channel) + position;
+            auto* input = state.gsmSignalInput.data() + gsmSignalCounter;
+            auto* output = state.gsmSignalOutput.data() + gsmSignalCounter;
             
-            //================ GSM processing block ================
-            // sync data rate to downsampling counter
-            if (downsamplingCounter == 0)
+            for (int sample = 0; sample < runLength; ++sample)
             {
-                // still working with src
-                gsmSignalInput.get()[gsmSignalCounter] = static_cast<gsm_signal>(src[sample] * 4096.0f);
-
-                gsmSignalInput.get()[gsmSignalCounter] <<= 3;
-                gsmSignalInput.get()[gsmSignalCounter] &= 0b1111111111111000;
-                
-                // increment gsm frame
-                ++gsmSignalCounter;
-                gsmSignalCounter %= 160;
+                // resampling filter may overshoot
+                float in = juce::jlimit(-1.0f, 1.0f, gsmData[sample]);
+                // 13-bit PCM, left-justified as gsm_encode expects
+                input[sample] = static_cast<gsm_signal>(static_cast<gsm_signal>(in * 4095.0f) * 8);
                 
-                // sync data rate to gsm frame
-                if (gsmSignalCounter == 0)
-                {
-                    std::swap(gsmSignalInput, gsmSignal);
-                    gsm_encode(encode.get(), gsmSignal.get(), gsmFrame.get());
-                    gsm_decode(decode.get(), gsmFrame.get(), gsmSignal.get());
-                    std::swap(gsmSignal, gsmSignalOutput);
-                }
-
-                gsmSignalOutput.get()[gsmSignalCounter] >>= 3;
-                // sample has moved from src -> gsm -> currentSample
-                currentSample = static_cast<float>(gsmSignalOutput.get()[gsmSignalCounter]) / 4096.0f;
+                // decoded sample from the same slot of the previous frame
+                gsmData[sample] = static_cast<float>(output[sample] >> 3) / 4096.0f;
             }
-            // return sample to src for filtering
-            src[sample] = currentSample;
-            
-            // increment downsampling frame
-            ++downsamplingCounter;
-            downsamplingCounter %= parameters.downsampling;
+        }
+        
+        position += runLength;
+        gsmSignalCounter += runLength;
+        
+        // sync data rate to gsm frame
+        if (gsmSignalCounter == frameSize)
+        {
+            gsmSignalCounter = 0;
             
-            //================= post-filtering block =================
-            // post-filter and compensate if downsampling
-            if (parameters.downsampling > 1)
+            // up to GSM_MAX_STREAMS channels share each pass through the codec
+            for (int first = 0; first < numChannels; first += GSM_MAX_STREAMS)
             {
-                // post-filtering
-                for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
+                int numStreams = juce::jmin(numChannels - first, GSM_MAX_STREAMS);
+                
+                std::array<gsm, GSM_MAX_STREAMS> encoders, decoders;
+                std::array<gsm_signal*, GSM_MAX_STREAMS> inputs, outputs;
+                
+                for (int stream = 0; stream < numStreams; ++stream)
                 {
-                    src[sample] = postFilters[filter].processSample(src[sample]);
-                    postFilters[filter].snapToZero();
+                    auto& state = channels[first + stream];
+                    encoders[stream] = &state.encode;
+                    decoders[stream] = &state.decode;
+                    inputs[stream] = state.gsmSignalInput.data();
+                    outputs[stream] = state.gsmSignalOutput.data();
                 }
-                // compensate - was 0.18 here and in pre-filter, but
-                // clipped, even though level sounded about equal
-//                src[sample] *= 1.0f + ((parameters.downsampling - 1.0f) * 0.18);
-            }
-            
-            //================== mono buffer -> stereo buffer =========
-            for (int channel = 0; channel < numChannels; ++channel)
-            {
-                auto* dst = buffer.getWritePointer(channel);
-                // sample has moved from src -> dst
-                dst[sample] = src[sample];
+                
+                // nothing reads the 33-byte frame, so the coded parameters go straight to the decoder
+                gsm_transcode_multi(numStreams, encoders.data(), decoders.data(), inputs.data(), outputs.data());
             }
         }
     }
+    
+    //================= post-filtering block =================
+    // back to the host rate
+    for (int channel = 0; channel < numChannels; ++channel)
+        resampler.interpolate(channel, buffer.getWritePointer(channel), numSamples);
 }
 
-void GSMProcessor::reset() {}
+void GSMProcessor::reset()
+{
+    resampler.reset();
+    
+    for (auto& channel : channels)
+    {
+        channel.gsmSignalInput.fill(0);
+        channel.gsmSignalOutput.fill(0);
+        channel.lowCutFilter.reset();
+        channel.heldSample = 0.0f;
+    }
+    
+    gsmSignalCounter = 0;
+    holdCounter = 0;
+}
 
 CodecProcessorParameters& GSMProcessor::getParameters() { return parameters; }
 
 void GSMProcessor::setParameters(const CodecProcessorParameters& params)
 {
-    if (parameters.downsampling != params.downsampling)
-    {
-        // coefficients
-        filterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((sampleRate / params.downsampling) * 0.4, sampleRate, 8);
-        
-        for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
-        {
-            // update each pre-filter
-            preFilters[filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-            
-            // update each post-filter
-            postFilters[filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-        }
-    }
-    
     parameters = params;
 }
+
+int GSMProcessor::getLatencySamples() const noexcept
+{
+    return resampler.getLatencySamples() + frameLatency;
+}
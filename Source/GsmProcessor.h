@@ -1,7 +1,9 @@
 #pragma once
 
-#include <memory>
+#include <array>
+#include <vector>
 #include <JuceHeader.h>
+#include "FixedRateResampler.h"
 #include "Utilities.h"
 
 extern "C" {
@@ -15,41 +17,49 @@ extern "C" {
 //==============================================================================
 class GSMProcessor : public CodecProcessorBase
 {
-    std::unique_ptr<gsm_state> encode = std::make_unique<gsm_state>();
-    std::unique_ptr<gsm_state> decode = std::make_unique<gsm_state>();
-    std::unique_ptr<gsm_signal[]> gsmSignalInput = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_signal[]> gsmSignal = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_signal[]> gsmSignalOutput = std::make_unique<gsm_signal[]>(160);
-    std::unique_ptr<gsm_byte[]> gsmFrame = std::make_unique<gsm_byte[]>(33);
+    static constexpr int frameSize = 160;
+    
+    // one codec per channel; all channels share frame boundaries
+    struct Channel
+    {
+        gsm_state encode {};
+        gsm_state decode {};
+        std::array<gsm_signal, frameSize> gsmSignalInput {};
+        std::array<gsm_signal, frameSize> gsmSignalOutput {};
+        
+        juce::dsp::IIR::Filter<float> lowCutFilter;
+        float heldSample = 0.0f;
+    };
+    
+    std::vector<Channel> channels;
     
     CodecProcessorParameters parameters;
     
-    float sampleRate = 44100;
     int gsmSignalCounter = 0;
-    int downsamplingCounter = 0;
-    int resamplingFilterOrder = 8;
     
-    float currentSample = 0.0f;
+    // one frame, in host samples
+    int frameLatency = 0;
     
-    using IIR = juce::dsp::IIR::Filter<float>;
-    IIR lowCutFilter;
-    std::vector<IIR> preFilters;
-    std::vector<IIR> postFilters;
+    // the downsampling parameter holds each codec-rate sample this many times
+    int holdCounter = 0;
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> filterCoefficientsArray;
+    FixedRateResampler resampler;
     
 public:
     GSMProcessor();
     
-    ~GSMProcessor() override;
+    ~GSMProcessor();
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void reset();
     
-    void reset() override;
+    CodecProcessorParameters& getParameters();
     
-    CodecProcessorParameters& getParameters() override;
+    void setParameters(const CodecProcessorParameters& params);
     
-    void setParameters(const CodecProcessorParameters& params) override;
+    // host samples the output lags the input by
+    int getLatencySamples() const noexcept;
 };
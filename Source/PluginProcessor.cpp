@@ -53,7 +53,12 @@ RSTelecomAudioProcessor::RSTelecomAudioProcessor()
                                                      { "slot2", 1 },
                                                      "Slot 2",
                                                      juce::StringArray { "None", "GSM 06.10", "Opus", "Mu-Law", "A-Law" },
-                                                     0)
+                                                     0),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID
+                                                     { "companderBits", 1 },
+                                                     "Mu/A-Law Bits",
+                                                     juce::StringArray { "3 bit", "4 bit", "5 bit", "6 bit", "7 bit", "8 bit" },
+                                                     5)
     })
 {
     downsamplingParameter = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("downsampling"));
@@ -65,10 +70,17 @@ RSTelecomAudioProcessor::RSTelecomAudioProcessor()
     
     slot1MenuParameter = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("slot1"));
     slot2MenuParameter = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("slot2"));
+    
+    companderBitsParameter = static_cast<juce::AudioParameterChoice*>(parameters.getParameter("companderBits"));
+    
+    // realtime codec changes are built here on the message thread; offline renders
+    // build them in processBlock so automation lands on the block it belongs to
+    startTimerHz(30);
 }
 
 RSTelecomAudioProcessor::~RSTelecomAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -136,6 +148,21 @@ void RSTelecomAudioProcessor::changeProgramName (int index, const juce::String&
 //==============================================================================
 void RSTelecomAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
+    spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
+    
+    // some hosts prepare off the message thread, so this can race the timer's updateCodecs()
+    const juce::ScopedLock lock(codecLock);
+    
+    slots[0].prepare(spec, slot1MenuParameter->getIndex(), getCodecParameters());
+    slots[1].prepare(spec, slot2MenuParameter->getIndex(), getCodecParameters());
+    
+    for (auto& slot : slots)
+        slot.setCrossfadeLength(codecCrossfadeSeconds);
+    
+    updateLatency();
 }
 
 void RSTelecomAudioProcessor::releaseResources()
@@ -192,45 +219,59 @@ void RSTelecomAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         }
     }
     
-    // codecs
-    slotCodecs[0] = slot1MenuParameter->getIndex();
-    slotCodecs[1] = slot2MenuParameter->getIndex();
+    // update parameters, process audio
+    auto codecParameters = getCodecParameters();
     
-    // create and initialize processors
-    for (int i = 0; i < numProcessorSlots; ++i)
-    {
-        if (slotCodecs[i] != prevSlotCodecs[i])
-        {
-            slotProcessors[i] = processorFactory.create(slotCodecs[i]);
-            
-            if (slotProcessors[i] != nullptr)
-            {
-                juce::dsp::ProcessSpec spec;
-                spec.sampleRate = getSampleRate();
-                spec.maximumBlockSize = buffer.getNumSamples();
-                spec.numChannels = buffer.getNumChannels();
-                
-                slotProcessors[i]->prepare(spec);
-            }
-            
-            prevSlotCodecs[i] = slotCodecs[i];
-        }
-    }
+    // no timer can keep pace with an offline render, and nothing here is realtime
+    if (isNonRealtime())
+        updateCodecs();
     
-    // update parameters, process audio
-    for (int i = 0; i < numProcessorSlots; ++i)
-    {
-        if (slotProcessors[i] != nullptr)
-        {
-            processorParameters = slotProcessors[i]->getParameters();
-            processorParameters.downsampling = downsamplingParameter->getIndex() + 1;
-            processorParameters.bitrate = bitrateParameter->getIndex() + 1;
-            
-            slotProcessors[i]->setParameters(processorParameters);
-            
-            slotProcessors[i]->processBlock(buffer, midiMessages);
-        }
-    }
+    // two companders in a row can run as a single table lookup
+    if (slots[0].processFused(slots[1], buffer, codecParameters))
+        return;
+    
+    for (auto& slot : slots)
+        slot.processBlock(buffer, midiMessages, codecParameters);
+}
+
+void RSTelecomAudioProcessor::timerCallback()
+{
+    if (! isNonRealtime())
+        updateCodecs();
+}
+
+void RSTelecomAudioProcessor::updateCodecs()
+{
+    // the timer and an offline processBlock may overlap while the host switches modes
+    const juce::ScopedLock lock(codecLock);
+    
+    slots[0].requestCodec(slot1MenuParameter->getIndex(), getCodecParameters());
+    slots[1].requestCodec(slot2MenuParameter->getIndex(), getCodecParameters());
+    
+    for (auto& slot : slots)
+        slot.collectGarbage();
+    
+    updateLatency();
+}
+
+void RSTelecomAudioProcessor::updateLatency()
+{
+    // the resampling filters, and GSM's frame, delay the signal; let the host compensate
+    int latency = slots[0].getLatencySamples() + slots[1].getLatencySamples();
+    
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+CodecProcessorParameters RSTelecomAudioProcessor::getCodecParameters() const
+{
+    CodecProcessorParameters params;
+    params.downsampling = downsamplingParameter->getIndex() + 1;
+    params.bitrate = bitrateParameter->getIndex() + 1;
+    // choices run from 3 bits up to plain 8-bit G.711
+    params.companderBits = companderBitsParameter->getIndex() + 3;
+    
+    return params;
 }
 
 //==============================================================================
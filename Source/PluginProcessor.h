@@ -4,33 +4,9 @@
 
 #include <JuceHeader.h>
 
-#include "CompanderProcessor.h"
-#include "GsmProcessor.h"
-#include "VoxProcessor.h"
+#include "CodecSlot.h"
 #include "Utilities.h"
 
-struct ProcessorFactory
-{
-    std::unique_ptr<CodecProcessorBase> create(int type)
-    {
-        auto iter = processorMapping.find(type);
-        if (iter != processorMapping.end())
-            return iter->second();
-        
-        return nullptr;
-    }
-    
-    std::map<int,
-             std::function<std::unique_ptr<CodecProcessorBase>()>> processorMapping
-    {
-        { 1, []() { return std::make_unique<GSMProcessor>(); } },
-        { 2, []() { return std::make_unique<MuLawProcessor>(); } },
-        { 3, []() { return std::make_unique<ALawProcessor>(); } },
-        { 4, []() { return std::make_unique<VoxProcessor>(); } }
-    };
-};
-
-
 //==============================================================================
 /**
 */
@@ -38,6 +14,7 @@ class RSTelecomAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private juce::Timer
 {
 public:
     //==============================================================================
@@ -90,16 +67,25 @@ private:
     juce::AudioParameterChoice* slot1MenuParameter = nullptr;
     juce::AudioParameterChoice* slot2MenuParameter = nullptr;
     
-    ProcessorFactory processorFactory {};
+    juce::AudioParameterChoice* companderBitsParameter = nullptr;
+    
+    void timerCallback() override;
+    
+    // builds requested codecs and frees retired ones; never called from realtime audio
+    void updateCodecs();
+    
+    // held by everything that builds or frees the slots' processors
+    juce::CriticalSection codecLock;
     
-    std::vector<std::unique_ptr<CodecProcessorBase>> slotProcessors = std::vector<std::unique_ptr<CodecProcessorBase>> { 2 };
+    // reports what the slots' processors currently delay the signal by
+    void updateLatency();
     
-    CodecProcessorParameters processorParameters;
+    CodecProcessorParameters getCodecParameters() const;
     
-    std::vector<int> slotCodecs { 0, 0 };
-    std::vector<int> prevSlotCodecs { -1, -1 };
+    std::array<CodecSlot, 2> slots;
     
-    int numProcessorSlots = 2;
+    // length of the crossfade when a slot changes codec
+    static constexpr double codecCrossfadeSeconds = 0.05;
         
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RSTelecomAudioProcessor)
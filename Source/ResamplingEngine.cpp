@@ -0,0 +1,268 @@
+#include "ResamplingEngine.h"
+
+std::mutex ResamplingKernelCache::lock;
+std::map<ResamplingKernelCache::Key, std::weak_ptr<const ResamplingKernels>> ResamplingKernelCache::kernels;
+
+std::shared_ptr<const ResamplingKernels> ResamplingKernelCache::get(double sampleRate, int factor, double cutoff, int tapsPerPhase)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Key key { sampleRate, factor, cutoff, tapsPerPhase };
+
+    if (auto cached = kernels[key].lock())
+        return cached;
+
+    // drop whatever no engine is using any more
+    for (auto entry = kernels.begin(); entry != kernels.end();)
+        entry = entry->second.expired() ? kernels.erase(entry) : std::next(entry);
+
+    auto designed = design(sampleRate, factor, cutoff, tapsPerPhase);
+    kernels[key] = designed;
+
+    return designed;
+}
+
+std::shared_ptr<const ResamplingKernels> ResamplingKernelCache::design(double sampleRate, int factor, double cutoff, int tapsPerPhase)
+{
+    auto result = std::make_shared<ResamplingKernels>();
+    result->factor = factor;
+
+    // default is the same corner as the old Butterworth resampling filters
+    int numTaps = factor * tapsPerPhase;
+    double frequency = cutoff > 0.0 ? cutoff : (sampleRate / factor) * 0.4;
+    auto prototype = juce::dsp::FilterDesign<float>::designFIRLowpassWindowMethod(static_cast<float>(frequency),
+                                                                                  sampleRate,
+                                                                                  static_cast<size_t>(numTaps - 1),
+                                                                                  juce::dsp::WindowingFunction<float>::kaiser,
+                                                                                  8.0f);
+    const float* taps = prototype->getRawCoefficients();
+
+    // unity gain at DC
+    float sum = 0.0f;
+    for (int tap = 0; tap < numTaps; ++tap)
+        sum += taps[tap];
+
+    // time-reversed so each output is a forward dot product over the history
+    result->decimator.resize(numTaps);
+    for (int tap = 0; tap < numTaps; ++tap)
+        result->decimator[tap] = taps[numTaps - 1 - tap] / sum;
+
+    // branch p holds taps p, p + factor, p + 2 * factor...
+    result->interpolator.resize(numTaps);
+    for (int phase = 0; phase < factor; ++phase)
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+            result->interpolator[phase * tapsPerPhase + (tapsPerPhase - 1 - tap)] = factor * taps[tap * factor + phase] / sum;
+
+    return result;
+}
+
+//==============================================================================
+ResamplingEngine::ResamplingEngine() = default;
+
+ResamplingEngine::~ResamplingEngine() = default;
+
+void ResamplingEngine::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    allocateHistory(spec);
+
+    preparedKernels.assign(maxDownsampling + 1, nullptr);
+
+    for (int newFactor = 2; newFactor <= maxDownsampling; ++newFactor)
+        preparedKernels[newFactor] = ResamplingKernelCache::get(spec.sampleRate, newFactor, 0.0, tapsPerPhase);
+
+    factor = juce::jlimit(1, maxDownsampling, factor);
+    kernels = preparedKernels[factor].get();
+
+    reset();
+}
+
+void ResamplingEngine::prepare(const juce::dsp::ProcessSpec& spec, int fixedFactor, double cutoff)
+{
+    allocateHistory(spec);
+
+    fixedFactor = juce::jlimit(1, maxFactor, fixedFactor);
+    preparedKernels.assign(fixedFactor + 1, nullptr);
+
+    if (fixedFactor > 1)
+        preparedKernels[fixedFactor] = ResamplingKernelCache::get(spec.sampleRate, fixedFactor, cutoff, tapsPerPhase);
+
+    factor = fixedFactor;
+    kernels = preparedKernels[factor].get();
+
+    reset();
+}
+
+void ResamplingEngine::allocateHistory(const juce::dsp::ProcessSpec& spec)
+{
+    int numChannels = static_cast<int>(spec.numChannels);
+    int maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+
+    inputHistory.resize(numChannels);
+    lowRateHistory.resize(numChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        inputHistory[channel].resize(decimatorHistory + maxBlockSize);
+        lowRateHistory[channel].resize(interpolatorHistory + maxBlockSize);
+    }
+
+    decimatorPhase.resize(numChannels);
+    interpolatorPhase.resize(numChannels);
+}
+
+void ResamplingEngine::reset()
+{
+    for (auto& history : inputHistory)
+        std::fill(history.begin(), history.end(), 0.0f);
+
+    for (auto& history : lowRateHistory)
+        std::fill(history.begin(), history.end(), 0.0f);
+
+    std::fill(decimatorPhase.begin(), decimatorPhase.end(), 0);
+    std::fill(interpolatorPhase.begin(), interpolatorPhase.end(), 0);
+}
+
+void ResamplingEngine::setFactor(int newFactor)
+{
+    if (newFactor == factor)
+        return;
+
+    // only factors fetched in prepare() can be selected here
+    const ResamplingKernels* newKernels = nullptr;
+
+    if (newFactor > 1)
+    {
+        newKernels = newFactor < static_cast<int>(preparedKernels.size()) ? preparedKernels[newFactor].get() : nullptr;
+
+        jassert (newKernels != nullptr);
+        if (newKernels == nullptr)
+            return;
+    }
+
+    factor = juce::jmax(1, newFactor);
+    kernels = newKernels;
+
+    // restart the phase so decimate/interpolate stay in step
+    std::fill(decimatorPhase.begin(), decimatorPhase.end(), 0);
+    std::fill(interpolatorPhase.begin(), interpolatorPhase.end(), 0);
+}
+
+int ResamplingEngine::decimate(int channel, const float* input, int numSamples)
+{
+    jassert (numSamples <= static_cast<int>(inputHistory[channel].size()) - decimatorHistory);
+
+    auto* lowRate = getLowRateData(channel);
+
+    if (factor == 1)
+    {
+        juce::FloatVectorOperations::copy(lowRate, input, numSamples);
+        return numSamples;
+    }
+
+    auto& history = inputHistory[channel];
+    auto& phase = decimatorPhase[channel];
+    int numTaps = factor * tapsPerPhase;
+    int historyLength = numTaps - 1;
+
+    // append the block after the last decimatorHistory input samples
+    juce::FloatVectorOperations::copy(history.data() + decimatorHistory, input, numSamples);
+
+    int numOut = 0;
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // only the retained samples are filtered
+        if (phase == 0)
+        {
+            const float* window = history.data() + decimatorHistory + sample - (numTaps - 1);
+            lowRate[numOut++] = dotProduct(kernels->decimator.data(), window, numTaps);
+        }
+
+        if (++phase == factor)
+            phase = 0;
+    }
+
+    // keep the inputs the next block's first window reaches back to, right before the block
+    auto* end = history.data() + decimatorHistory + numSamples;
+    std::copy(end - historyLength, end, history.data() + decimatorHistory - historyLength);
+
+    return numOut;
+}
+
+void ResamplingEngine::interpolate(int channel, float* output, int numSamples)
+{
+    auto& history = lowRateHistory[channel];
+
+    if (factor == 1)
+    {
+        juce::FloatVectorOperations::copy(output, history.data() + interpolatorHistory, numSamples);
+        return;
+    }
+
+    auto& phase = interpolatorPhase[channel];
+
+    // newest low-rate sample consumed so far; history holds the previous tapsPerPhase
+    int current = interpolatorHistory - 1;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        if (phase == 0)
+            ++current;
+
+        const float* window = history.data() + current - (tapsPerPhase - 1);
+        output[sample] = dotProduct(kernels->interpolator.data() + phase * tapsPerPhase, window, tapsPerPhase);
+
+        if (++phase == factor)
+            phase = 0;
+    }
+
+    int numConsumed = current - (interpolatorHistory - 1);
+    std::copy(history.begin() + numConsumed, history.begin() + numConsumed + interpolatorHistory, history.begin());
+}
+
+float ResamplingEngine::dotProduct(const float* a, const float* b, int numTaps) noexcept
+{
+    // every kernel is a whole number of tapsPerPhase, so there's no remainder loop
+    jassert (numTaps % 16 == 0);
+
+   // MSVC never defines __SSE2__ for x64, where SSE2 is always there
+   #if JUCE_USE_SIMD && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    // the window slides one sample per output, so the loads are unaligned
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+
+    for (int tap = 0; tap < numTaps; tap += 16)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + tap),      _mm_loadu_ps(b + tap)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + tap + 4),  _mm_loadu_ps(b + tap + 4)));
+        sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(a + tap + 8),  _mm_loadu_ps(b + tap + 8)));
+        sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(a + tap + 12), _mm_loadu_ps(b + tap + 12)));
+    }
+
+    __m128 sum = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+    return _mm_cvtss_f32(sum);
+   #elif JUCE_USE_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+    float32x4_t sum0 = vdupq_n_f32(0.0f), sum1 = vdupq_n_f32(0.0f), sum2 = vdupq_n_f32(0.0f), sum3 = vdupq_n_f32(0.0f);
+
+    for (int tap = 0; tap < numTaps; tap += 16)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + tap),      vld1q_f32(b + tap));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + tap + 4),  vld1q_f32(b + tap + 4));
+        sum2 = vmlaq_f32(sum2, vld1q_f32(a + tap + 8),  vld1q_f32(b + tap + 8));
+        sum3 = vmlaq_f32(sum3, vld1q_f32(a + tap + 12), vld1q_f32(b + tap + 12));
+    }
+
+    float32x4_t sum = vaddq_f32(vaddq_f32(sum0, sum1), vaddq_f32(sum2, sum3));
+    float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+   #else
+    float sum = 0.0f;
+
+    for (int tap = 0; tap < numTaps; ++tap)
+        sum += a[tap] * b[tap];
+
+    return sum;
+   #endif
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+//==============================================================================
+/** Time-reversed polyphase FIR kernels for one decimation factor. Never modified once built. */
+struct ResamplingKernels
+{
+    int factor = 1;
+    std::vector<float> decimator;
+    std::vector<float> interpolator;    // [phase][tap], scaled by factor
+};
+
+//==============================================================================
+/**
+    Process-wide store of ResamplingKernels, shared by every engine in every
+    plugin instance. Only touched from prepare() on the message thread; the
+    audio thread reads kernels through the engine's own references and never
+    drops the last one.
+*/
+class ResamplingKernelCache
+{
+public:
+    // designs the kernels on first use for this (sampleRate, factor, cutoff, taps)
+    static std::shared_ptr<const ResamplingKernels> get(double sampleRate, int factor, double cutoff, int tapsPerPhase);
+
+private:
+    static std::shared_ptr<const ResamplingKernels> design(double sampleRate, int factor, double cutoff, int tapsPerPhase);
+
+    using Key = std::tuple<double, int, double, int>;
+
+    static std::mutex lock;
+    static std::map<Key, std::weak_ptr<const ResamplingKernels>> kernels;
+};
+
+//==============================================================================
+/**
+    Block-based polyphase FIR decimator/interpolator shared by the codec processors.
+
+    decimate() low-pass filters a block and keeps every factor-th sample,
+    computing only the retained outputs. The processor runs its codec over
+    getLowRateData(), then interpolate() brings that data back to the host rate
+    using one polyphase branch per output sample. Both sides advance the same
+    phase, so interpolate() consumes exactly what decimate() produced for the
+    same block.
+*/
+class ResamplingEngine
+{
+public:
+    ResamplingEngine();
+
+    ~ResamplingEngine();
+
+    // fetches kernels for every downsampling factor, corner at 0.4 of the decimated rate
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    // fetches kernels for a single factor with the corner at cutoff Hz
+    void prepare(const juce::dsp::ProcessSpec& spec, int fixedFactor, double cutoff);
+
+    void reset();
+
+    // only selects one of the prepared kernel sets, so it is safe on the audio thread.
+    // 1 bypasses the filters; the host-rate samples go to the codec unchanged
+    void setFactor(int newFactor);
+
+    int getFactor() const noexcept { return factor; }
+
+    // returns the number of low-rate samples written to getLowRateData(channel)
+    int decimate(int channel, const float* input, int numSamples);
+
+    // the codec reads and writes the decimated block here, in place
+    float* getLowRateData(int channel) noexcept { return lowRateHistory[static_cast<size_t>(channel)].data() + interpolatorHistory; }
+
+    // reads the low-rate samples from the matching decimate() call
+    void interpolate(int channel, float* output, int numSamples);
+
+    // delay of decimate() then interpolate() at the current factor, in host samples:
+    // half a kernel on the way down and half on the way back up
+    int getLatencySamples() const noexcept { return factor > 1 ? factor * tapsPerPhase - 1 : 0; }
+
+    // 8x for the downsampling parameter, up to 48x to reach 8 kHz from 384 kHz
+    static constexpr int maxDownsampling = 8;
+    static constexpr int maxFactor = 48;
+    static constexpr int tapsPerPhase = 16;
+
+private:
+    void allocateHistory(const juce::dsp::ProcessSpec& spec);
+
+    static float dotProduct(const float* a, const float* b, int numTaps) noexcept;
+
+    int factor = 1;
+
+    // indexed by factor; null for factors that weren't prepared
+    std::vector<std::shared_ptr<const ResamplingKernels>> preparedKernels;
+    const ResamplingKernels* kernels = nullptr;
+
+    // room for the longest kernel's history; each call only keeps what the current factor needs
+    static constexpr int decimatorHistory = maxFactor * tapsPerPhase - 1;
+    static constexpr int interpolatorHistory = tapsPerPhase;
+
+    std::vector<std::vector<float>> inputHistory;
+    std::vector<std::vector<float>> lowRateHistory;
+    std::vector<int> decimatorPhase;
+    std::vector<int> interpolatorPhase;
+};
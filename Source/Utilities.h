@@ -39,31 +39,26 @@ struct CodecProcessorParameters
         {
             downsampling = params.downsampling;
             bitrate = params.bitrate;
+            companderBits = params.companderBits;
         }
         return *this;
     }
     
     int downsampling = 1;
     int bitrate = 1;
+    // bits of each Mu-Law/A-Law code that survive, 3 to 8
+    int companderBits = 8;
     // needs glitch-related params
 };
 
+// Codec processors are dispatched statically through CodecVariant (see
+// CodecSlot.h), so there is no virtual interface here. Every processor
+// provides prepare(), processBlock(), reset(), getParameters(),
+// setParameters() and getLatencySamples() with the usual juce signatures.
 class CodecProcessorBase
 {
 public:
     CodecProcessorBase() {}
-    
-    virtual ~CodecProcessorBase() {}
-    
-    virtual void prepare(const juce::dsp::ProcessSpec& spec) = 0;
-    
-    virtual void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) = 0;
-    
-    virtual void reset() = 0;
-    
-    virtual CodecProcessorParameters& getParameters() = 0;
-    
-    virtual void setParameters(const CodecProcessorParameters& params) = 0;
 };
 
 class LockGuardedPosInfo
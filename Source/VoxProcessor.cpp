@@ -38,7 +38,7 @@ uint8_t VoxCodec::voxEncode(int16_t& inSample) {
     if (diff < 0) { 
         bits |= 0b1000; 
     }
-    diff = std::abs<int16_t>(diff);
+    diff = static_cast<int16_t>(std::abs(diff));
     if (diff >= stepSize) {
         bits |= 0b0100;
         diff -= stepSize;
@@ -115,35 +115,24 @@ VoxProcessor::~VoxProcessor() = default;
 
 void VoxProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    sampleRate = static_cast<int>(spec.sampleRate);
     int numChannels = static_cast<int>(spec.numChannels);
     
     auto lowCutCoefficients = dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, 20.0f);
     
-    filterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((sampleRate / parameters.downsampling) * 0.4, sampleRate, resamplingFilterOrder);
+    // Dialogic ADPCM is specified at 8 kHz
+    resampler.prepare(spec, 8000.0);
     
     vox.resize(numChannels);
+    holdCounter.resize(numChannels);
+    heldSample.resize(numChannels);
     
     postLowCutFilter.resize(numChannels);
-    preFilters.resize(numChannels);
-    postFilters.resize(numChannels);
     
     for (int channel = 0; channel < numChannels; ++channel)
     {
-        preFilters[channel].resize(resamplingFilterOrder / 2);
-        postFilters[channel].resize(resamplingFilterOrder / 2);
-        
         postLowCutFilter[channel].reset();
         postLowCutFilter[channel].prepare(spec);
         postLowCutFilter[channel].coefficients = lowCutCoefficients;
-        
-        for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
-        {
-            // prepare each post-filter
-            postFilters[channel][filter].reset();
-            postFilters[channel][filter].prepare(spec);
-            postFilters[channel][filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-        }
     }
     
     reset();
@@ -158,10 +147,22 @@ void VoxProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
     {
         auto* channelData = buffer.getWritePointer(channel);
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        // band-limit and resample to exactly 8 kHz
+        int numDecimated = resampler.decimate(channel, channelData, numSamples);
+        auto* voxData = resampler.getLowRateData(channel);
+        
+        for (int sample = 0; sample < numDecimated; ++sample)
         {
-            // scale -1–1 to 16-bit int range
-            int16_t pcmIn = static_cast<int16_t>(channelData[sample] * ((1 << 12) - 1));
+            // sample and hold below 8 kHz for the downsampling parameter
+            if (holdCounter[channel] == 0)
+                heldSample[channel] = voxData[sample];
+            
+            if (++holdCounter[channel] >= parameters.downsampling)
+                holdCounter[channel] = 0;
+            
+            // scale -1–1 to 16-bit int range; resampling filter may overshoot
+            float input = std::clamp(heldSample[channel], -1.0f, 1.0f);
+            int16_t pcmIn = static_cast<int16_t>(input * ((1 << 12) - 1));
             uint8_t compressed = vox[channel].voxEncode(pcmIn);
             // if noise gate closed, alternate +/- 0
             // compressed = VOX_RESET_TABLE[sample %= 2];
@@ -170,37 +171,40 @@ void VoxProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuff
             //     resetCounter += 1;
             // }
             int16_t pcmOut = vox[channel].voxDecode(compressed);
-            channelData[sample] = static_cast<float>(pcmOut) / ((1 << 15) - 1);
-            channelData[sample] = postLowCutFilter[channel].processSample(channelData[sample]);
-            postLowCutFilter[channel].snapToZero();
+            voxData[sample] = static_cast<float>(pcmOut) / ((1 << 15) - 1);
         }
+        
+        // back to the host rate
+        resampler.interpolate(channel, channelData, numSamples);
+        
+        for (int sample = 0; sample < numSamples; ++sample)
+            channelData[sample] = postLowCutFilter[channel].processSample(channelData[sample]);
+        
+        // once per block is enough to keep the filter state out of the denormal range
+        postLowCutFilter[channel].snapToZero();
     }
 }
 
-void VoxProcessor::reset() {}
+void VoxProcessor::reset()
+{
+    resampler.reset();
+    
+    std::fill(holdCounter.begin(), holdCounter.end(), 0);
+    std::fill(heldSample.begin(), heldSample.end(), 0.0f);
+}
 
 CodecProcessorParameters& VoxProcessor::getParameters() { return parameters; }
 
 void VoxProcessor::setParameters(const CodecProcessorParameters& params)
 {
-    // coefficients
-    filterCoefficientsArray = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((sampleRate / params.downsampling) * 0.4, sampleRate, resamplingFilterOrder);
-    
-    for (int channel = 0; channel < preFilters.size(); ++channel)
-    {
-        for (int filter = 0; filter < resamplingFilterOrder / 2; ++filter)
-        {
-            // update each pre-filter
-            preFilters[channel][filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-            
-            // update each post-filter
-            postFilters[channel][filter].coefficients = filterCoefficientsArray.getObjectPointer(filter);
-        }
-    }
-
     parameters = params;
 }
 
+int VoxProcessor::getLatencySamples() const noexcept
+{
+    return resampler.getLatencySamples();
+}
+
 // uint8_t VoxProcessor::voxEncode(int16_t& inSample) {
 //     // calculate differece btwn last time/this; divide by 16 because we're working at 12
 //     // bits
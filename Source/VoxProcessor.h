@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FixedRateResampler.h"
 #include "Utilities.h"
 #include "juce_dsp/juce_dsp.h"
 #include <JuceHeader.h>
@@ -46,17 +47,20 @@ class VoxProcessor : public CodecProcessorBase
 public:
     VoxProcessor();
     
-    ~VoxProcessor() override;
+    ~VoxProcessor();
     
-    void prepare(const juce::dsp::ProcessSpec& spec) override;
+    void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     
-    void reset() override;
+    void reset();
+    
+    CodecProcessorParameters& getParameters();
     
-    CodecProcessorParameters& getParameters() override;
+    void setParameters(const CodecProcessorParameters& params);
     
-    void setParameters(const CodecProcessorParameters& params) override;
+    // host samples the output lags the input by
+    int getLatencySamples() const noexcept;
     
 private:
     // uint8_t voxEncode(int16_t& inSample, VoxState& state);
@@ -78,15 +82,12 @@ private:
     
     CodecProcessorParameters parameters;
     
-    float sampleRate = 44100;
-    int resamplingFilterOrder = 8;
-    std::vector<int> downsamplingCounter { 0, 0 };
-    std::vector<float> downsamplingInput { 0.0f, 0.0f };
-    
     using IIR = juce::dsp::IIR::Filter<float>;
     std::vector<IIR> postLowCutFilter;
-    std::vector<std::vector<IIR>> preFilters;
-    std::vector<std::vector<IIR>> postFilters;
     
-    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> filterCoefficientsArray;
+    FixedRateResampler resampler;
+    
+    // the downsampling parameter holds each codec-rate sample this many times
+    std::vector<int> holdCounter;
+    std::vector<float> heldSample;
 };
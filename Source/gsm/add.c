@@ -13,6 +13,10 @@
 #include	<stdio.h>
 #include	<assert.h>
 
+#ifndef	GSM_OUT_OF_LINE
+#define	GSM_OUT_OF_LINE	/* the reference definitions, not the inline ones */
+#endif
+
 #include	"private.h"
 #include	"gsm.h"
 #include	"proto.h"
@@ -24,30 +24,14 @@
  *  4.2 FIXED POINT IMPLEMENTATION OF THE RPE-LTP CODER 
  */
 
-void Gsm_Coder P8((S,s,LARc,Nc,bc,Mc,xmaxc,xMc),
-
-	struct gsm_state	* S,
-
-	word	* s,	/* [0..159] samples		  	IN	*/
-
 /*
- * The RPE-LTD coder works on a frame by frame basis.  The length of
- * the frame is equal to 160 samples.  Some computations are done
- * once per frame to produce at the output of the coder the
- * LARc[1..8] parameters which are the coded LAR coefficients and 
- * also to realize the inverse filtering operation for the entire
- * frame (160 samples of signal d[0..159]).  These parts produce at
- * the output of the coder:
+ *  4.2.11 .. 4.2.18, four times per frame, on the short term residual
  */
+static void Coder_subsegments P7((S,so,Nc,bc,Mc,xmaxc,xMc),
 
-	word	* LARc,	/* [0..7] LAR coefficients		OUT	*/
-
-/*
- * Procedure 4.2.11 to 4.2.18 are to be executed four times per
- * frame.  That means once for each sub-segment RPE-LTP analysis of
- * 40 samples.  These parts produce at the output of the coder:
- */
+	struct gsm_state	* S,
 
+	word	* so,	/* [0..159] short term residual	IN	*/
 	word	* Nc,	/* [0..3] LTP lag			OUT 	*/
 	word	* bc,	/* [0..3] coded LTP gain		OUT 	*/
 	word	* Mc,	/* [0..3] RPE grid selection		OUT     */
@@ -59,12 +43,6 @@ void Gsm_Coder P8((S,s,LARc,Nc,bc,Mc,xmaxc,xMc),
 	word	* dp  = S->dp0 + 120;	/* [ -120...-1 ] */
 	word	* dpp = dp;		/* [ 0...39 ]	 */
 
-	word	so[160];
-
-	Gsm_Preprocess			(S, s, so);
-	Gsm_LPC_Analysis		(S, so, LARc);
-	Gsm_Short_Term_Analysis_Filter	(S, LARc, so);
-
 	for (k = 0; k <= 3; k++, xMc += 13) {
 
 		Gsm_Long_Term_Predictor	( S,
@@ -95,3 +73,74 @@ void Gsm_Coder P8((S,s,LARc,Nc,bc,Mc,xmaxc,xMc),
 	(void)memcpy( (char *)S->dp0, (char *)(S->dp0 + 160),
 		120 * sizeof(*S->dp0) );
 }
+
+void Gsm_Coder P8((S,s,LARc,Nc,bc,Mc,xmaxc,xMc),
+
+	struct gsm_state	* S,
+
+	word	* s,	/* [0..159] samples		  	IN	*/
+
+/*
+ * The RPE-LTD coder works on a frame by frame basis.  The length of
+ * the frame is equal to 160 samples.  Some computations are done
+ * once per frame to produce at the output of the coder the
+ * LARc[1..8] parameters which are the coded LAR coefficients and 
+ * also to realize the inverse filtering operation for the entire
+ * frame (160 samples of signal d[0..159]).  These parts produce at
+ * the output of the coder:
+ */
+
+	word	* LARc,	/* [0..7] LAR coefficients		OUT	*/
+
+/*
+ * Procedure 4.2.11 to 4.2.18 are to be executed four times per
+ * frame.  That means once for each sub-segment RPE-LTP analysis of
+ * 40 samples.  These parts produce at the output of the coder:
+ */
+
+	word	* Nc,	/* [0..3] LTP lag			OUT 	*/
+	word	* bc,	/* [0..3] coded LTP gain		OUT 	*/
+	word	* Mc,	/* [0..3] RPE grid selection		OUT     */
+	word	* xmaxc,/* [0..3] Coded maximum amplitude	OUT	*/
+	word	* xMc	/* [13*4] normalized RPE samples	OUT	*/
+)
+{
+	word	so[160];
+
+	Gsm_Preprocess			(S, s, so);
+	Gsm_LPC_Analysis		(S, so, LARc);
+	Gsm_Short_Term_Analysis_Filter	(S, LARc, so);
+
+	Coder_subsegments		(S, so, Nc, bc, Mc, xmaxc, xMc);
+}
+
+/*
+ *  The same for n <= GSM_MAX_STREAMS independent streams.  The short term
+ *  analysis lattices, which are serial per stream, run side by side;
+ *  the rest is done stream by stream.
+ */
+void Gsm_Coder_multi P4((n,S,s,p),
+	int			n,
+	struct gsm_state	** S,
+	word			** s,	/* [n][0..159] samples		IN	*/
+	struct gsm_parameters	* p)	/* [n] coded parameters		OUT	*/
+{
+	int	i;
+	word	so[ GSM_MAX_STREAMS ][160];
+	word	* sop[ GSM_MAX_STREAMS ];
+	word	* LARcp[ GSM_MAX_STREAMS ];
+
+	for (i = 0; i < n; i++) {
+		sop[i]   = so[i];
+		LARcp[i] = p[i].LARc;
+
+		Gsm_Preprocess		(S[i], s[i], so[i]);
+		Gsm_LPC_Analysis	(S[i], so[i], p[i].LARc);
+	}
+
+	Gsm_Short_Term_Analysis_Filter_multi (n, S, LARcp, sop);
+
+	for (i = 0; i < n; i++)
+		Coder_subsegments	(S[i], so[i], p[i].Nc, p[i].bc, p[i].Mc,
+					 p[i].xmaxc, p[i].xMc);
+}
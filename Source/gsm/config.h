@@ -14,6 +14,7 @@
 
 #define	HAS_STDLIB_H	1		/* /usr/include/stdlib.h	*/
 #define	HAS_LIMITS_H	1		/* /usr/include/limits.h	*/
+#define	HAS_STDINT_H	1		/* /usr/include/stdint.h	*/
 #define	HAS_FCNTL_H	1		/* /usr/include/fcntl.h		*/
 #define	HAS_ERRNO_DECL	1		/* errno.h declares errno	*/
 
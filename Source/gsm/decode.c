@@ -33,21 +33,19 @@ static void Postprocessing P2((S,s),
 	S->msr = msr;
 }
 
-void Gsm_Decoder P8((S,LARcr, Ncr,bcr,Mcr,xmaxcr,xMcr,s),
+static void Decoder_subsegments P7((S,Ncr,bcr,Mcr,xmaxcr,xMcr,wt),
 	struct gsm_state	* S,
 
-	word		* LARcr,	/* [0..7]		IN	*/
-
 	word		* Ncr,		/* [0..3] 		IN 	*/
 	word		* bcr,		/* [0..3]		IN	*/
 	word		* Mcr,		/* [0..3] 		IN 	*/
 	word		* xmaxcr,	/* [0..3]		IN 	*/
 	word		* xMcr,		/* [0..13*4]		IN	*/
 
-	word		* s)		/* [0..159]		OUT 	*/
+	word		* wt)		/* [0..159]		OUT 	*/
 {
 	int		j, k;
-	word		erp[40], wt[160];
+	word		erp[40];
 	word		* drp = S->dp0 + 120;
 
 	for (j=0; j <= 3; j++, xmaxcr++, bcr++, Ncr++, Mcr++, xMcr += 13) {
@@ -57,7 +55,53 @@ void Gsm_Decoder P8((S,LARcr, Ncr,bcr,Mcr,xmaxcr,xMcr,s),
 
 		for (k = 0; k <= 39; k++) wt[ j * 40 + k ] =  drp[ k ];
 	}
+}
+
+void Gsm_Decoder P8((S,LARcr, Ncr,bcr,Mcr,xmaxcr,xMcr,s),
+	struct gsm_state	* S,
+
+	word		* LARcr,	/* [0..7]		IN	*/
+
+	word		* Ncr,		/* [0..3] 		IN 	*/
+	word		* bcr,		/* [0..3]		IN	*/
+	word		* Mcr,		/* [0..3] 		IN 	*/
+	word		* xmaxcr,	/* [0..3]		IN 	*/
+	word		* xMcr,		/* [0..13*4]		IN	*/
+
+	word		* s)		/* [0..159]		OUT 	*/
+{
+	word		wt[160];
+
+	Decoder_subsegments( S, Ncr, bcr, Mcr, xmaxcr, xMcr, wt );
 
 	Gsm_Short_Term_Synthesis_Filter( S, LARcr, wt, s );
 	Postprocessing(S, s);
 }
+
+/*
+ *  The same for n <= GSM_MAX_STREAMS independent streams, with the short
+ *  term synthesis lattices run side by side.
+ */
+void Gsm_Decoder_multi P4((n,S,p,s),
+	int			n,
+	struct gsm_state	** S,
+	struct gsm_parameters	* p,	/* [n] coded parameters	IN	*/
+	word			** s)	/* [n][0..159]		OUT	*/
+{
+	int		i;
+	word		wt[ GSM_MAX_STREAMS ][160];
+	word		* wtp[ GSM_MAX_STREAMS ];
+	word		* LARcrp[ GSM_MAX_STREAMS ];
+
+	for (i = 0; i < n; i++) {
+		wtp[i]    = wt[i];
+		LARcrp[i] = p[i].LARc;
+
+		Decoder_subsegments( S[i], p[i].Nc, p[i].bc, p[i].Mc,
+				     p[i].xmaxc, p[i].xMc, wt[i] );
+	}
+
+	Gsm_Short_Term_Synthesis_Filter_multi( n, S, LARcrp, wtp, s );
+
+	for (i = 0; i < n; i++) Postprocessing(S[i], s[i]);
+}
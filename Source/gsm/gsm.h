@@ -54,6 +54,8 @@ typedef gsm_byte 		gsm_frame[33];		/* 33 * 8 bits	 */
 #define	GSM_OPT_FRAME_INDEX	5
 #define	GSM_OPT_FRAME_CHAIN	6
 
+#define	GSM_MAX_STREAMS		8	/* for gsm_encode_multi/decode_multi */
+
 extern gsm  gsm_create 	GSM_P((void));
 extern void gsm_destroy GSM_P((gsm));	
 
@@ -63,6 +65,14 @@ extern int  gsm_option  GSM_P((gsm, int, int *));
 extern void gsm_encode  GSM_P((gsm, gsm_signal *, gsm_byte  *));
 extern int  gsm_decode  GSM_P((gsm, gsm_byte   *, gsm_signal *));
 
+/*  n independent streams, one frame each; n <= GSM_MAX_STREAMS  */
+extern void gsm_encode_multi GSM_P((int, gsm *, gsm_signal **, gsm_byte **));
+extern int  gsm_decode_multi GSM_P((int, gsm *, gsm_byte **, gsm_signal **));
+
+/*  gsm_encode() into one state, gsm_decode() from another, without the frame  */
+extern void gsm_transcode       GSM_P((gsm, gsm, gsm_signal *, gsm_signal *));
+extern void gsm_transcode_multi GSM_P((int, gsm *, gsm *, gsm_signal **, gsm_signal **));
+
 extern int  gsm_explode GSM_P((gsm, gsm_byte   *, gsm_signal *));
 extern void gsm_implode GSM_P((gsm, gsm_signal *, gsm_byte   *));
 
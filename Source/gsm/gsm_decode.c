@@ -11,10 +11,19 @@
 #include "gsm.h"
 #include "proto.h"
 
-int gsm_decode P3((s, c, target), gsm s, gsm_byte * c, gsm_signal * target)
+static int gsm_unpack P8((s, c, LARc, Nc, bc, Mc, xmaxc, xmc),
+	gsm		s,
+	gsm_byte	* c,
+	word		* LARc,
+	word		* Nc,
+	word		* bc,
+	word		* Mc,
+	word		* xmaxc,
+	word		* xmc)
 {
-	word  	LARc[8], Nc[4], Mc[4], bc[4], xmaxc[4], xmc[13*4];
-
+#ifndef WAV49
+	(void)s;	/* only the WAV #49 framing keeps state */
+#endif
 #ifdef WAV49
 	if (s->wav_fmt) {
 
@@ -355,7 +364,34 @@ int gsm_decode P3((s, c, target), gsm s, gsm_byte * c, gsm_signal * target)
 		xmc[51]  = *c & 0x7;			/* 33 */
 	}
 
+	return 0;
+}
+
+int gsm_decode P3((s, c, target), gsm s, gsm_byte * c, gsm_signal * target)
+{
+	word  	LARc[8], Nc[4], Mc[4], bc[4], xmaxc[4], xmc[13*4];
+
+	if (gsm_unpack(s, c, LARc, Nc, bc, Mc, xmaxc, xmc)) return -1;
+
 	Gsm_Decoder(s, LARc, Nc, bc, Mc, xmaxc, xmc, target);
 
 	return 0;
 }
+
+int gsm_decode_multi P4((n, s, c, target),
+	int		n,
+	gsm		* s,
+	gsm_byte	** c,
+	gsm_signal	** target)
+{
+	struct gsm_parameters	p[ GSM_MAX_STREAMS ];
+	int			i;
+
+	for (i = 0; i < n; i++)
+		if (gsm_unpack(s[i], c[i], p[i].LARc, p[i].Nc, p[i].bc, p[i].Mc,
+			       p[i].xmaxc, p[i].xMc)) return -1;
+
+	Gsm_Decoder_multi(n, s, p, target);
+
+	return 0;
+}
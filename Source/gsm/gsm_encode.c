@@ -10,12 +10,19 @@
 #include "gsm.h"
 #include "proto.h"
 
-void gsm_encode P3((s, source, c), gsm s, gsm_signal * source, gsm_byte * c)
+static void gsm_pack P8((s, LARc, Nc, bc, Mc, xmaxc, xmc, c),
+	gsm		s,
+	word		* LARc,
+	word		* Nc,
+	word		* bc,
+	word		* Mc,
+	word		* xmaxc,
+	word		* xmc,
+	gsm_byte	* c)
 {
-	word	 	LARc[8], Nc[4], Mc[4], bc[4], xmaxc[4], xmc[13*4];
-
-	Gsm_Coder(s, source, LARc, Nc, bc, Mc, xmaxc, xmc);
-
+#ifndef WAV49
+	(void)s;	/* only the WAV #49 framing keeps state */
+#endif
 
 	/*	variable	size
 
@@ -449,3 +456,27 @@ void gsm_encode P3((s, source, c), gsm s, gsm_signal * source, gsm_byte * c)
 
 	}
 }
+
+void gsm_encode P3((s, source, c), gsm s, gsm_signal * source, gsm_byte * c)
+{
+	word	 	LARc[8], Nc[4], Mc[4], bc[4], xmaxc[4], xmc[13*4];
+
+	Gsm_Coder(s, source, LARc, Nc, bc, Mc, xmaxc, xmc);
+	gsm_pack(s, LARc, Nc, bc, Mc, xmaxc, xmc, c);
+}
+
+void gsm_encode_multi P4((n, s, source, c),
+	int		n,
+	gsm		* s,
+	gsm_signal	** source,
+	gsm_byte	** c)
+{
+	struct gsm_parameters	p[ GSM_MAX_STREAMS ];
+	int			i;
+
+	Gsm_Coder_multi(n, s, source, p);
+
+	for (i = 0; i < n; i++)
+		gsm_pack(s[i], p[i].LARc, p[i].Nc, p[i].bc, p[i].Mc,
+			 p[i].xmaxc, p[i].xMc, c[i]);
+}
@@ -0,0 +1,36 @@
+/*
+ *  Encode a frame and decode it straight away, handing the coded
+ *  parameters from coder to decoder without packing them into a
+ *  33 byte frame in between.  The output is exactly what gsm_encode()
+ *  followed by gsm_decode() produces.
+ */
+
+#include "private.h"
+
+#include "gsm.h"
+#include "proto.h"
+
+void gsm_transcode P4((e, d, source, target),
+	gsm		e,		/* encoder state		*/
+	gsm		d,		/* decoder state		*/
+	gsm_signal	* source,	/* [0..159]		IN	*/
+	gsm_signal	* target)	/* [0..159]		OUT	*/
+{
+	word	 	LARc[8], Nc[4], Mc[4], bc[4], xmaxc[4], xmc[13*4];
+
+	Gsm_Coder(e, source, LARc, Nc, bc, Mc, xmaxc, xmc);
+	Gsm_Decoder(d, LARc, Nc, bc, Mc, xmaxc, xmc, target);
+}
+
+void gsm_transcode_multi P5((n, e, d, source, target),
+	int		n,
+	gsm		* e,
+	gsm		* d,
+	gsm_signal	** source,
+	gsm_signal	** target)
+{
+	struct gsm_parameters	p[ GSM_MAX_STREAMS ];
+
+	Gsm_Coder_multi(n, e, source, p);
+	Gsm_Decoder_multi(n, d, p, target);
+}
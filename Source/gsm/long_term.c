@@ -165,6 +165,7 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	word		wt[40];
 
 	longword	L_max, L_power;
+	longword	L_cc[81];	/* [40..120] */
 	word		R, S, dmax, scal;
 	register word	temp;
 
@@ -200,7 +201,17 @@ static void Calculation_of_the_LTP_parameters P4((d,dp,bc_out,Nc_out),
 	L_max = 0;
 	Nc    = 40;	/* index for the maximum cross-correlation */
 
-	for (lambda = 40; lambda <= 120; lambda++) {
+	if (gsm_simd_ltp_correlation( wt, dp, L_cc )) {
+
+		for (lambda = 40; lambda <= 120; lambda++) {
+			if (L_cc[lambda - 40] > L_max) {
+
+				Nc    = lambda;
+				L_max = L_cc[lambda - 40];
+			}
+		}
+
+	} else for (lambda = 40; lambda <= 120; lambda++) {
 
 # undef STEP
 #		define STEP(k) 	(longword)wt[k] * dp[k - lambda]
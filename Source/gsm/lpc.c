@@ -90,6 +90,9 @@ static void Autocorrelation P2((s, L_ACF),
 
 	/*  Compute the L_ACF[..].
 	 */
+#ifndef	USE_FLOAT_MUL
+	if (!gsm_simd_autocorrelation( s, L_ACF ))
+#endif
 	{
 # ifdef	USE_FLOAT_MUL
 		register float * sp = float_s;
@@ -9,11 +9,24 @@
 #ifndef	PRIVATE_H
 #define	PRIVATE_H
 
+#include "config.h"
+
+/*  GSM_NO_STDINT keeps the original short/long types, for comparison  */
+#if defined(HAS_STDINT_H) && !defined(GSM_NO_STDINT)
+#include <stdint.h>
+
+typedef int16_t			word;		/* 16 bit signed int	*/
+typedef int32_t			longword;	/* 32 bit signed int	*/
+
+typedef uint16_t		uword;		/* unsigned word	*/
+typedef uint32_t		ulongword;	/* unsigned longword	*/
+#else
 typedef short			word;		/* 16 bit signed int	*/
 typedef long			longword;	/* 32 bit signed int	*/
 
 typedef unsigned short		uword;		/* unsigned word	*/
 typedef unsigned long		ulongword;	/* unsigned longword	*/
+#endif
 
 struct gsm_state {
 
@@ -102,10 +115,10 @@ extern word	gsm_asr  	P((word a, int n));
 # define GSM_L_ADD(a, b)	\
 	( (a) <  0 ? ( (b) >= 0 ? (a) + (b)	\
 		 : (utmp = (ulongword)-((a) + 1) + (ulongword)-((b) + 1)) \
-		   >= MAX_LONGWORD ? MIN_LONGWORD : -(longword)utmp-2 )   \
+		   >= (ulongword)MAX_LONGWORD ? MIN_LONGWORD : -(longword)utmp-2 )   \
 	: ((b) <= 0 ? (a) + (b)   \
-	          : (utmp = (ulongword)(a) + (ulongword)(b)) >= MAX_LONGWORD \
-		    ? MAX_LONGWORD : utmp))
+	          : (utmp = (ulongword)(a) + (ulongword)(b)) >= (ulongword)MAX_LONGWORD \
+		    ? MAX_LONGWORD : (longword)utmp))
 
 /*
  * # define GSM_ADD(a, b)	\
@@ -138,9 +151,159 @@ extern word	gsm_asr  	P((word a, int n));
 
 */
 
+/*
+ *  Inline versions of the add.c functions, for compilers with the
+ *  builtins.  Same results bit for bit; add.c keeps the out-of-line
+ *  definitions (and defines GSM_OUT_OF_LINE to get at them).  C only:
+ *  C++ code that includes this header for the types never calls them.
+ */
+#if !defined(GSM_OUT_OF_LINE) && !defined(__cplusplus) && \
+	((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+
+static __inline__ word gsm_inline_add P2((a,b), word a, word b)
+{
+	longword sum = (longword)a + (longword)b;
+	return sum < MIN_WORD ? MIN_WORD : sum > MAX_WORD ? MAX_WORD : sum;
+}
+
+static __inline__ word gsm_inline_sub P2((a,b), word a, word b)
+{
+	longword diff = (longword)a - (longword)b;
+	return diff < MIN_WORD ? MIN_WORD : diff > MAX_WORD ? MAX_WORD : diff;
+}
+
+static __inline__ word gsm_inline_mult P2((a,b), word a, word b)
+{
+	if (a == MIN_WORD && b == MIN_WORD) return MAX_WORD;
+	return SASR( (longword)a * (longword)b, 15 );
+}
+
+static __inline__ word gsm_inline_mult_r P2((a,b), word a, word b)
+{
+	if (b == MIN_WORD && a == MIN_WORD) return MAX_WORD;
+	return 0xFFFF & (((longword)a * (longword)b + 16384) >> 15);
+}
+
+static __inline__ word gsm_inline_abs P1((a), word a)
+{
+	return a < 0 ? (a == MIN_WORD ? MAX_WORD : -a) : a;
+}
+
+static __inline__ longword gsm_inline_L_mult P2((a,b), word a, word b)
+{
+	return ((longword)a * (longword)b) << 1;
+}
+
+/*  32 bit saturation, whatever the width of longword  */
+
+static __inline__ longword gsm_inline_L_add P2((a,b), longword a, longword b)
+{
+	int	sum;
+	if (__builtin_add_overflow(a, b, &sum))
+		return a < 0 ? MIN_LONGWORD : MAX_LONGWORD;
+	return sum;
+}
+
+static __inline__ longword gsm_inline_L_sub P2((a,b), longword a, longword b)
+{
+	int	diff;
+	if (__builtin_sub_overflow(a, b, &diff))
+		return a < 0 ? MIN_LONGWORD : MAX_LONGWORD;
+	return diff;
+}
+
+/*
+ *  Leading zeros less one, from the bit count instead of bitoff[].
+ *  The low bit set in the argument makes norm(-1) = 31 come out
+ *  of the same expression.
+ */
+static __inline__ word gsm_inline_norm P1((a), longword a)
+{
+	if (a < 0) {
+		if (a <= -1073741824) return 0;
+		a = ~a;
+	}
+	return __builtin_clz( (unsigned int)a << 1 | 1 );
+}
+
+static __inline__ longword gsm_inline_L_asr P2((a,n), longword a, int n)
+{
+	if (n >= 32) return -(a < 0);
+	if (n <= -32) return 0;
+	if (n < 0) return a << -n;
+	return SASR(a, n);
+}
+
+static __inline__ longword gsm_inline_L_asl P2((a,n), longword a, int n)
+{
+	if (n >= 32) return 0;
+	if (n <= -32) return -(a < 0);
+	if (n < 0) return gsm_inline_L_asr(a, -n);
+	return a << n;
+}
+
+static __inline__ word gsm_inline_asr P2((a,n), word a, int n)
+{
+	if (n >= 16) return -(a < 0);
+	if (n <= -16) return 0;
+	if (n < 0) return a << -n;
+	return SASR(a, n);
+}
+
+static __inline__ word gsm_inline_asl P2((a,n), word a, int n)
+{
+	if (n >= 16) return 0;
+	if (n <= -16) return -(a < 0);
+	if (n < 0) return gsm_inline_asr(a, -n);
+	return a << n;
+}
+
+/*
+ *  Restoring division gives the first 15 bits of num/denum, which is
+ *  the quotient below except that num == denum gives all ones.
+ */
+static __inline__ word gsm_inline_div P2((num,denum), word num, word denum)
+{
+	longword	div;
+
+	if (num == 0) return 0;
+
+	div = ((longword)num << 15) / denum;
+	return div > MAX_WORD ? MAX_WORD : div;
+}
+
+#define	gsm_add(a, b)		gsm_inline_add(a, b)
+#define	gsm_sub(a, b)		gsm_inline_sub(a, b)
+#define	gsm_mult(a, b)		gsm_inline_mult(a, b)
+#define	gsm_mult_r(a, b)	gsm_inline_mult_r(a, b)
+#define	gsm_abs(a)		gsm_inline_abs(a)
+#define	gsm_L_mult(a, b)	gsm_inline_L_mult(a, b)
+#define	gsm_L_add(a, b)		gsm_inline_L_add(a, b)
+#define	gsm_L_sub(a, b)		gsm_inline_L_sub(a, b)
+#define	gsm_norm(a)		gsm_inline_norm(a)
+#define	gsm_L_asl(a, n)		gsm_inline_L_asl(a, n)
+#define	gsm_asl(a, n)		gsm_inline_asl(a, n)
+#define	gsm_L_asr(a, n)		gsm_inline_L_asr(a, n)
+#define	gsm_asr(a, n)		gsm_inline_asr(a, n)
+#define	gsm_div(num, denum)	gsm_inline_div(num, denum)
+
+#endif	/* inline add.c */
+
 /*
  *  More prototypes from implementations..
  */
+/*
+ *  Coded parameters of one frame, before packing / after unpacking
+ */
+struct gsm_parameters {
+	word	LARc[8];	/* [0..7] LAR coefficients		*/
+	word	Nc[4];		/* [0..3] LTP lag			*/
+	word	bc[4];		/* [0..3] coded LTP gain		*/
+	word	Mc[4];		/* [0..3] RPE grid selection		*/
+	word	xmaxc[4];	/* [0..3] Coded maximum amplitude	*/
+	word	xMc[13*4];	/* [13*4] normalized RPE samples	*/
+};
+
 extern void Gsm_Coder P((
 		struct gsm_state	* S,
 		word	* s,	/* [0..159] samples		IN	*/
@@ -151,6 +314,12 @@ extern void Gsm_Coder P((
 		word	* xmaxc,/* [0..3] Coded maximum amplitude OUT	*/
 		word	* xMc	/* [13*4] normalized RPE samples OUT	*/));
 
+extern void Gsm_Coder_multi P((		/* n <= GSM_MAX_STREAMS	*/
+		int			n,
+		struct gsm_state	** S,
+		word			** s,	/* [n][0..159]	IN	*/
+		struct gsm_parameters	* p));	/* [n]		OUT	*/
+
 extern void Gsm_Long_Term_Predictor P((		/* 4x for 160 samples */
 		struct gsm_state * S,
 		word	* d,	/* [0..39]   residual signal	IN	*/
@@ -192,6 +361,12 @@ extern void Gsm_Decoder P((
 		word	* xMcr,		/* [0..13*4]		IN	*/
 		word	* s));		/* [0..159]		OUT 	*/
 
+extern void Gsm_Decoder_multi P((		/* n <= GSM_MAX_STREAMS	*/
+		int			n,
+		struct gsm_state	** S,
+		struct gsm_parameters	* p,	/* [n]		IN	*/
+		word			** s));	/* [n][0..159]	OUT	*/
+
 extern void Gsm_Decoding P((
 		struct gsm_state * S,
 		word 	xmaxcr,
@@ -226,11 +401,72 @@ extern void Gsm_Short_Term_Synthesis_Filter P((
 		word	* drp,		/* received d [0...39]	   IN	*/
 		word	* s));		/* signal   s [0..159]	  OUT	*/
 
+/*
+ *  The same filters for n <= GSM_LANES independent streams at once
+ */
+extern void Gsm_Short_Term_Analysis_Filter_multi P((
+		int	n,
+		struct gsm_state ** S,
+		word	** LARc,	/* [n][0..7]		IN	*/
+		word	** s));		/* [n][0..159]		IN/OUT	*/
+
+extern void Gsm_Short_Term_Synthesis_Filter_multi P((
+		int	n,
+		struct gsm_state ** S,
+		word	** LARcr,	/* [n][0..7]		IN	*/
+		word	** wt,		/* [n][0..159]		IN	*/
+		word	** s));		/* [n][0..159]		OUT	*/
+
 extern void Gsm_Update_of_reconstructed_short_time_residual_signal P((
 		word	* dpp,		/* [0...39]	IN	*/
 		word	* ep,		/* [0...39]	IN	*/
 		word	* dp));		/* [-120...-1]  IN/OUT 	*/
 
+/*
+ *  SIMD kernels from simd.c; each returns 0 if the caller has to run
+ *  the reference code instead.
+ */
+extern int gsm_simd_autocorrelation P((
+		word	 * s,		/* [0..159]	IN	*/
+		longword * L_ACF));	/* [0..8]	OUT	*/
+
+extern int gsm_simd_ltp_correlation P((
+		word	 * wt,		/* [0..39]	IN	*/
+		word	 * dp,		/* [-120..-1]	IN	*/
+		longword * L_result));	/* [0..80]	OUT	*/
+
+extern int gsm_simd_weighting_filter P((
+		word	 * e,		/* [0..49]	IN	*/
+		word	 * x));		/* [0..39]	OUT	*/
+
+extern int gsm_simd_rpe_grid_energies P((
+		word	 * x,		/* [0..39]	IN	*/
+		longword * L_EM));	/* [0..3]	OUT	*/
+
+/*
+ *  Multi-stream kernels run GSM_LANES independent streams side by side
+ *  on lane-interleaved arrays, x[k * GSM_LANES + lane].
+ */
+#define	GSM_LANES	GSM_MAX_STREAMS
+
+/*  0 if the kernels below would only run the reference arithmetic
+ *  lane by lane; the multi-stream filters then go stream by stream.
+ */
+extern int gsm_simd_available P((void));
+
+extern void gsm_simd_short_term_analysis P((
+		word	* rp,		/* [0..7][lanes]	IN	*/
+		word	* u,		/* [0..7][lanes]	IN/OUT	*/
+		int	k_n,
+		word	* s));		/* [0..k_n-1][lanes]	IN/OUT	*/
+
+extern void gsm_simd_short_term_synthesis P((
+		word	* rrp,		/* [0..7][lanes]	IN	*/
+		word	* v,		/* [0..8][lanes]	IN/OUT	*/
+		int	k,
+		word	* wt,		/* [0..k-1][lanes]	IN	*/
+		word	* sr));		/* [0..k-1][lanes]	OUT	*/
+
 /*
  *  Tables from table.c
  */
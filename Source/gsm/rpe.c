@@ -49,6 +49,7 @@ static void Weighting_filter P2((e, x),
 
 	/*  Compute the signal x[0..39]
 	 */ 
+	if (!gsm_simd_weighting_filter( e, x ))
 	for (k = 0; k <= 39; k++) {
 
 		L_result = 8192 >> 1;
@@ -130,10 +131,23 @@ static void RPE_grid_selection P3((x,xM,Mc_out),
 	word			Mc;
 
 	longword		L_common_0_3;
+	longword		L_EM[4];
 
 	EM = 0;
 	Mc = 0;
 
+	if (gsm_simd_rpe_grid_energies( x, L_EM )) {
+
+		EM = L_EM[0];
+		for (i = 1; i <= 3; i++) {
+			if (L_EM[i] > EM) {
+				Mc = i;
+				EM = L_EM[i];
+			}
+		}
+
+	} else {
+
 	/* for (m = 0; m <= 3; m++) {
 	 *	L_result = 0;
 	 *
@@ -208,6 +222,7 @@ static void RPE_grid_selection P3((x,xM,Mc_out),
 		Mc = 3;
 	 	EM = L_result;
 	}
+	}
 
 	/**/
 
@@ -427,3 +427,120 @@ void Gsm_Short_Term_Synthesis_Filter P4((S, LARcr, wt, s),
 	LARp_to_rp( LARp );
 	FILTER(S, LARp, 120, wt + 40, s + 40);
 }
+
+/*
+ *  Multi-stream versions.  The coefficients are worked out per stream as
+ *  above; the lattices of all streams then run together, one per SIMD
+ *  lane.  Unused lanes carry zeros.
+ */
+
+static void Interpolated_rp_multi P4((n, S, LARc, rp),
+	int			n,
+	struct gsm_state	** S,
+	word			** LARc,	/* [n][0..7]		IN	*/
+	word			* rp)		/* [4][0..7][lanes]	OUT	*/
+{
+	int	lane, i, k;
+	word	LARp[4][8];
+
+	for (lane = 0; lane < n; lane++) {
+
+		word	* LARpp_j	= S[lane]->LARpp[ S[lane]->j      ];
+		word	* LARpp_j_1	= S[lane]->LARpp[ S[lane]->j ^= 1 ];
+
+		Decoding_of_the_coded_Log_Area_Ratios( LARc[lane], LARpp_j );
+
+		Coefficients_0_12(  LARpp_j_1, LARpp_j, LARp[0] );
+		Coefficients_13_26( LARpp_j_1, LARpp_j, LARp[1] );
+		Coefficients_27_39( LARpp_j_1, LARpp_j, LARp[2] );
+		Coefficients_40_159( LARpp_j, LARp[3] );
+
+		for (i = 0; i < 4; i++) {
+			LARp_to_rp( LARp[i] );
+			for (k = 0; k < 8; k++)
+				rp[(i * 8 + k) * GSM_LANES + lane] = LARp[i][k];
+		}
+	}
+}
+
+void Gsm_Short_Term_Analysis_Filter_multi P4((n, S, LARc, s),
+	int			n,
+	struct gsm_state	** S,
+	word			** LARc,	/* [n][0..7]	IN	*/
+	word			** s		/* [n][0..159]	IN/OUT	*/
+)
+{
+	word	rp[4 * 8 * GSM_LANES] = { 0 };
+	word	u[8 * GSM_LANES]      = { 0 };
+	word	x[160 * GSM_LANES]    = { 0 };
+	int	lane, k;
+
+	assert(n >= 1 && n <= GSM_LANES);
+
+	/*  Lane by lane, all GSM_LANES of them, costs more than the
+	 *  single stream filter it reproduces.
+	 */
+	if (!gsm_simd_available()) {
+		for (lane = 0; lane < n; lane++)
+			Gsm_Short_Term_Analysis_Filter( S[lane], LARc[lane], s[lane] );
+		return;
+	}
+
+	Interpolated_rp_multi( n, S, LARc, rp );
+
+	for (lane = 0; lane < n; lane++) {
+		for (k = 0; k < 8;   k++) u[k * GSM_LANES + lane] = S[lane]->u[k];
+		for (k = 0; k < 160; k++) x[k * GSM_LANES + lane] = s[lane][k];
+	}
+
+	gsm_simd_short_term_analysis( rp,                      u, 13,  x );
+	gsm_simd_short_term_analysis( rp +  8 * GSM_LANES,     u, 14,  x + 13 * GSM_LANES );
+	gsm_simd_short_term_analysis( rp + 16 * GSM_LANES,     u, 13,  x + 27 * GSM_LANES );
+	gsm_simd_short_term_analysis( rp + 24 * GSM_LANES,     u, 120, x + 40 * GSM_LANES );
+
+	for (lane = 0; lane < n; lane++) {
+		for (k = 0; k < 8;   k++) S[lane]->u[k] = u[k * GSM_LANES + lane];
+		for (k = 0; k < 160; k++) s[lane][k]    = x[k * GSM_LANES + lane];
+	}
+}
+
+void Gsm_Short_Term_Synthesis_Filter_multi P5((n, S, LARcr, wt, s),
+	int			n,
+	struct gsm_state	** S,
+	word			** LARcr,	/* [n][0..7]	IN	*/
+	word			** wt,		/* [n][0..159]	IN	*/
+	word			** s		/* [n][0..159]	OUT	*/
+)
+{
+	word	rrp[4 * 8 * GSM_LANES] = { 0 };
+	word	v[9 * GSM_LANES]       = { 0 };
+	word	x[160 * GSM_LANES]     = { 0 };
+	int	lane, k;
+
+	assert(n >= 1 && n <= GSM_LANES);
+
+	if (!gsm_simd_available()) {
+		for (lane = 0; lane < n; lane++)
+			Gsm_Short_Term_Synthesis_Filter( S[lane], LARcr[lane], wt[lane], s[lane] );
+		return;
+	}
+
+	Interpolated_rp_multi( n, S, LARcr, rrp );
+
+	for (lane = 0; lane < n; lane++) {
+		for (k = 0; k < 9;   k++) v[k * GSM_LANES + lane] = S[lane]->v[k];
+		for (k = 0; k < 160; k++) x[k * GSM_LANES + lane] = wt[lane][k];
+	}
+
+	/*  In place: each output only depends on the same or earlier inputs.
+	 */
+	gsm_simd_short_term_synthesis( rrp,                  v, 13,  x,                    x );
+	gsm_simd_short_term_synthesis( rrp +  8 * GSM_LANES, v, 14,  x + 13 * GSM_LANES,   x + 13 * GSM_LANES );
+	gsm_simd_short_term_synthesis( rrp + 16 * GSM_LANES, v, 13,  x + 27 * GSM_LANES,   x + 27 * GSM_LANES );
+	gsm_simd_short_term_synthesis( rrp + 24 * GSM_LANES, v, 120, x + 40 * GSM_LANES,   x + 40 * GSM_LANES );
+
+	for (lane = 0; lane < n; lane++) {
+		for (k = 0; k < 9;   k++) S[lane]->v[k] = v[k * GSM_LANES + lane];
+		for (k = 0; k < 160; k++) s[lane][k]    = x[k * GSM_LANES + lane];
+	}
+}
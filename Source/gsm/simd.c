@@ -0,0 +1,780 @@
+/*
+ *  SIMD versions of the fixed-point inner loops, chosen at run time.
+ *  Every kernel returns exactly what the scalar reference code computes.
+ *  The single-stream kernels report 0 when none is available and the
+ *  caller falls back; the multi-stream ones always run.
+ *
+ *  Define GSM_NO_SIMD to build the reference code only.
+ */
+
+#include <string.h>
+
+#include "private.h"
+
+#include "gsm.h"
+#include "proto.h"
+
+#undef	P
+
+#ifndef	GSM_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define	GSM_SIMD_SSE2	1
+#		include <emmintrin.h>
+#		if defined(__GNUC__) || defined(__clang__)
+#			define	GSM_SIMD_AVX2	1
+#			define	GSM_TARGET_AVX2	__attribute__((target("avx2")))
+#			include <immintrin.h>
+#		endif
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define	GSM_SIMD_NEON	1
+#		include <arm_neon.h>
+#	endif
+#endif
+
+#if defined(_MSC_VER)
+#	define	GSM_ALIGN(n)	__declspec(align(n))
+#else
+#	define	GSM_ALIGN(n)	__attribute__((aligned(n)))
+#endif
+
+#ifdef	GSM_SIMD_AVX2
+static int has_avx2 P0()
+{
+	/*  The runtime fills in the CPU model before main() runs,
+	 *  so this is a load and a test.
+	 */
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/*
+ *  4.2.4 Autocorrelation, L_ACF[k] = 2 * sum s[i] * s[i - k], k = 0..8
+ *
+ *  The signal has already been scaled so that |s[i]| <= 2048, which keeps
+ *  every partial sum below 2^30: 32-bit lanes add up exactly what the
+ *  longword reference accumulates.  Zeros in front of the signal stand
+ *  in for the terms the reference skips when i < k.
+ */
+
+#define	ACF_PAD	16
+
+#ifdef	GSM_SIMD_SSE2
+
+static longword hsum_sse2 P1((v), __m128i v)
+{
+	v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (longword)_mm_cvtsi128_si32(v);
+}
+
+static void autocorrelation_sse2 P2((sp, L_ACF),
+	word		* sp,		/* [-8..159]	IN	*/
+	longword	* L_ACF)	/* [0..8]	OUT	*/
+{
+	__m128i	acc[9];
+	int	i, k;
+
+	for (k = 0; k <= 8; k++) acc[k] = _mm_setzero_si128();
+
+	for (i = 0; i < 160; i += 8) {
+		__m128i x = _mm_load_si128((__m128i const *)(sp + i));
+		for (k = 0; k <= 8; k++) acc[k] = _mm_add_epi32(acc[k],
+			_mm_madd_epi16(x,
+				_mm_loadu_si128((__m128i const *)(sp + i - k))));
+	}
+
+	for (k = 0; k <= 8; k++) L_ACF[k] = hsum_sse2(acc[k]) << 1;
+}
+
+#endif	/* GSM_SIMD_SSE2 */
+
+#ifdef	GSM_SIMD_AVX2
+
+GSM_TARGET_AVX2
+static void autocorrelation_avx2 P2((sp, L_ACF),
+	word		* sp,		/* [-8..159]	IN	*/
+	longword	* L_ACF)	/* [0..8]	OUT	*/
+{
+	__m256i	acc[9];
+	int	i, k;
+
+	for (k = 0; k <= 8; k++) acc[k] = _mm256_setzero_si256();
+
+	for (i = 0; i < 160; i += 16) {
+		__m256i x = _mm256_load_si256((__m256i const *)(sp + i));
+		for (k = 0; k <= 8; k++) acc[k] = _mm256_add_epi32(acc[k],
+			_mm256_madd_epi16(x,
+				_mm256_loadu_si256((__m256i const *)(sp + i - k))));
+	}
+
+	for (k = 0; k <= 8; k++) {
+		__m128i v = _mm_add_epi32(_mm256_castsi256_si128(acc[k]),
+					  _mm256_extracti128_si256(acc[k], 1));
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		L_ACF[k] = (longword)_mm_cvtsi128_si32(v) << 1;
+	}
+}
+
+#endif	/* GSM_SIMD_AVX2 */
+
+#ifdef	GSM_SIMD_NEON
+
+static longword hsum_neon P1((v), int32x4_t v)
+{
+	int32x2_t h = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+	return (longword)vget_lane_s32(vpadd_s32(h, h), 0);
+}
+
+static void autocorrelation_neon P2((sp, L_ACF),
+	word		* sp,		/* [-8..159]	IN	*/
+	longword	* L_ACF)	/* [0..8]	OUT	*/
+{
+	int32x4_t	acc[9];
+	int		i, k;
+
+	for (k = 0; k <= 8; k++) acc[k] = vdupq_n_s32(0);
+
+	for (i = 0; i < 160; i += 8) {
+		int16x8_t x = vld1q_s16(sp + i);
+		for (k = 0; k <= 8; k++) {
+			int16x8_t y = vld1q_s16(sp + i - k);
+			acc[k] = vmlal_s16(acc[k], vget_low_s16(x),  vget_low_s16(y));
+			acc[k] = vmlal_s16(acc[k], vget_high_s16(x), vget_high_s16(y));
+		}
+	}
+
+	for (k = 0; k <= 8; k++) L_ACF[k] = hsum_neon(acc[k]) << 1;
+}
+
+#endif	/* GSM_SIMD_NEON */
+
+int gsm_simd_autocorrelation P2((s, L_ACF),
+	word		* s,		/* [0..159]	IN	*/
+	longword	* L_ACF)	/* [0..8]	OUT	*/
+{
+#if defined(GSM_SIMD_SSE2) || defined(GSM_SIMD_NEON)
+	GSM_ALIGN(32) word	padded[ ACF_PAD + 160 ];
+	word			* sp = padded + ACF_PAD;
+
+	memset(padded, 0, ACF_PAD * sizeof(word));
+	memcpy(sp, s, 160 * sizeof(word));
+#endif
+
+#ifdef	GSM_SIMD_AVX2
+	if (has_avx2()) {
+		autocorrelation_avx2(sp, L_ACF);
+		return 1;
+	}
+#endif
+
+#if defined(GSM_SIMD_SSE2)
+	autocorrelation_sse2(sp, L_ACF);
+	return 1;
+#elif defined(GSM_SIMD_NEON)
+	autocorrelation_neon(sp, L_ACF);
+	return 1;
+#else
+	(void)s; (void)L_ACF;
+	return 0;
+#endif
+}
+
+/*
+ *  4.2.11 LTP lag search, L_result[lambda - 40] = sum wt[k] * dp[k - lambda]
+ *  for k = 0..39 and lambda = 40..120.
+ *
+ *  wt has been scaled so that |wt[k]| <= 512, which keeps every sum below
+ *  2^30; 32-bit lanes are exact.  Four lags are reduced together.
+ */
+
+#ifdef	GSM_SIMD_SSE2
+
+static __m128i hsum4_sse2 P4((a0, a1, a2, a3),
+	__m128i a0, __m128i a1, __m128i a2, __m128i a3)
+{
+	/*  Returns { sum(a0), sum(a1), sum(a2), sum(a3) }.
+	 */
+	__m128i s0 = _mm_add_epi32(_mm_unpacklo_epi32(a0, a1),
+				   _mm_unpackhi_epi32(a0, a1));
+	__m128i s1 = _mm_add_epi32(_mm_unpacklo_epi32(a2, a3),
+				   _mm_unpackhi_epi32(a2, a3));
+	return _mm_add_epi32(_mm_unpacklo_epi64(s0, s1),
+			     _mm_unpackhi_epi64(s0, s1));
+}
+
+static __m128i ltp_lag_sse2 P3((w, dp, lambda),
+	__m128i	* w,
+	word	* dp,
+	int	lambda)
+{
+	word	* x = dp - lambda;
+	__m128i	acc;
+	int	k;
+
+	acc = _mm_madd_epi16(w[0], _mm_loadu_si128((__m128i const *)x));
+	for (k = 1; k < 5; k++) acc = _mm_add_epi32(acc,
+		_mm_madd_epi16(w[k], _mm_loadu_si128((__m128i const *)(x + 8 * k))));
+	return acc;
+}
+
+static void ltp_correlation_sse2 P3((wt, dp, L_result),
+	word		* wt,		/* [0..39]	IN	*/
+	word		* dp,		/* [-120..-1]	IN	*/
+	longword	* L_result)	/* [0..80]	OUT	*/
+{
+	GSM_ALIGN(16) int	sums[4];
+	__m128i			w[5];
+	int			k, lambda;
+
+	for (k = 0; k < 5; k++) w[k] = _mm_loadu_si128((__m128i const *)(wt + 8 * k));
+
+	for (lambda = 40; lambda + 3 <= 120; lambda += 4) {
+		_mm_store_si128((__m128i *)sums, hsum4_sse2(
+			ltp_lag_sse2(w, dp, lambda),
+			ltp_lag_sse2(w, dp, lambda + 1),
+			ltp_lag_sse2(w, dp, lambda + 2),
+			ltp_lag_sse2(w, dp, lambda + 3)));
+		for (k = 0; k < 4; k++) L_result[lambda - 40 + k] = sums[k];
+	}
+	L_result[120 - 40] = hsum_sse2(ltp_lag_sse2(w, dp, 120));
+}
+
+#endif	/* GSM_SIMD_SSE2 */
+
+#ifdef	GSM_SIMD_AVX2
+
+GSM_TARGET_AVX2
+static __m128i ltp_lag_avx2 P4((w, w4, dp, lambda),
+	__m256i	* w,
+	__m128i	w4,
+	word	* dp,
+	int	lambda)
+{
+	word	* x = dp - lambda;
+	__m256i	acc;
+
+	acc = _mm256_add_epi32(
+		_mm256_madd_epi16(w[0], _mm256_loadu_si256((__m256i const *)x)),
+		_mm256_madd_epi16(w[1], _mm256_loadu_si256((__m256i const *)(x + 16))));
+
+	return _mm_add_epi32(
+		_mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)),
+		_mm_madd_epi16(w4, _mm_loadu_si128((__m128i const *)(x + 32))));
+}
+
+GSM_TARGET_AVX2
+static void ltp_correlation_avx2 P3((wt, dp, L_result),
+	word		* wt,		/* [0..39]	IN	*/
+	word		* dp,		/* [-120..-1]	IN	*/
+	longword	* L_result)	/* [0..80]	OUT	*/
+{
+	GSM_ALIGN(16) int	sums[4];
+	__m256i			w[2];
+	__m128i			w4;
+	int			k, lambda;
+
+	w[0] = _mm256_loadu_si256((__m256i const *)wt);
+	w[1] = _mm256_loadu_si256((__m256i const *)(wt + 16));
+	w4   = _mm_loadu_si128((__m128i const *)(wt + 32));
+
+	for (lambda = 40; lambda + 3 <= 120; lambda += 4) {
+		_mm_store_si128((__m128i *)sums, hsum4_sse2(
+			ltp_lag_avx2(w, w4, dp, lambda),
+			ltp_lag_avx2(w, w4, dp, lambda + 1),
+			ltp_lag_avx2(w, w4, dp, lambda + 2),
+			ltp_lag_avx2(w, w4, dp, lambda + 3)));
+		for (k = 0; k < 4; k++) L_result[lambda - 40 + k] = sums[k];
+	}
+	L_result[120 - 40] = hsum_sse2(ltp_lag_avx2(w, w4, dp, 120));
+}
+
+#endif	/* GSM_SIMD_AVX2 */
+
+#ifdef	GSM_SIMD_NEON
+
+static void ltp_correlation_neon P3((wt, dp, L_result),
+	word		* wt,		/* [0..39]	IN	*/
+	word		* dp,		/* [-120..-1]	IN	*/
+	longword	* L_result)	/* [0..80]	OUT	*/
+{
+	int16x8_t	w[5];
+	int		k, lambda;
+
+	for (k = 0; k < 5; k++) w[k] = vld1q_s16(wt + 8 * k);
+
+	for (lambda = 40; lambda <= 120; lambda++) {
+		word		* x = dp - lambda;
+		int32x4_t	acc = vdupq_n_s32(0);
+
+		for (k = 0; k < 5; k++) {
+			int16x8_t y = vld1q_s16(x + 8 * k);
+			acc = vmlal_s16(acc, vget_low_s16(w[k]),  vget_low_s16(y));
+			acc = vmlal_s16(acc, vget_high_s16(w[k]), vget_high_s16(y));
+		}
+		L_result[lambda - 40] = hsum_neon(acc);
+	}
+}
+
+#endif	/* GSM_SIMD_NEON */
+
+int gsm_simd_ltp_correlation P3((wt, dp, L_result),
+	word		* wt,		/* [0..39]	IN	*/
+	word		* dp,		/* [-120..-1]	IN	*/
+	longword	* L_result)	/* [0..80]	OUT	*/
+{
+#ifdef	GSM_SIMD_AVX2
+	if (has_avx2()) {
+		ltp_correlation_avx2(wt, dp, L_result);
+		return 1;
+	}
+#endif
+
+#if defined(GSM_SIMD_SSE2)
+	ltp_correlation_sse2(wt, dp, L_result);
+	return 1;
+#elif defined(GSM_SIMD_NEON)
+	ltp_correlation_neon(wt, dp, L_result);
+	return 1;
+#else
+	(void)wt; (void)dp; (void)L_result;
+	return 0;
+#endif
+}
+
+/*
+ *  4.2.13 RPE weighting filter, x[k] = sat(4096 + sum e[k + i] * H[i] >> 13)
+ *  over the zero-padded window e[0..49], and 4.2.14 the grid energies
+ *  L_EM[m] = 2 * sum (x[m + 3 * i] >> 2)^2, i = 0..12.
+ *
+ *  sum |H[i]| * 32768 and 13 * 8192^2 * 2 both stay below 2^31.
+ *  H[2] and H[8] are zero, so the filter is five tap pairs (H[8] pads
+ *  the fourth) and never reads past e[49].
+ */
+
+#if defined(GSM_SIMD_SSE2) || defined(GSM_SIMD_NEON)
+
+#define	G3	-1, 0, 0
+#define	G3x4	G3, G3, G3, G3
+#define	G3x12	G3x4, G3x4, G3x4
+
+/*  grid_mask[m][k] selects x[m + 3 * i]  */
+static GSM_ALIGN(16) const word grid_mask[4][40] = {
+	{        G3x12, G3, 0 },
+	{ 0,     G3x12, G3 },
+	{ 0, 0,  G3x12, -1, 0 },
+	{ 0, 0, 0, G3x12, -1 }
+};
+
+#undef	G3x12
+#undef	G3x4
+#undef	G3
+
+#endif
+
+#ifdef	GSM_SIMD_SSE2
+
+#define	H_PAIR(h0, h1)	_mm_set_epi16(h1, h0, h1, h0, h1, h0, h1, h0)
+
+static void weighting_filter_sse2 P2((e, x),
+	word	* e,		/* [0..49]	IN	*/
+	word	* x)		/* [0..39]	OUT	*/
+{
+	static const int	tap[5] = { 0, 3, 5, 7, 9 };
+	__m128i			h[5];
+	int			k, i;
+
+	h[0] = H_PAIR( -134, -374 );
+	h[1] = H_PAIR( 2054, 5741 );
+	h[2] = H_PAIR( 8192, 5741 );
+	h[3] = H_PAIR( 2054,    0 );
+	h[4] = H_PAIR( -374, -134 );
+
+	for (k = 0; k < 40; k += 8) {
+		__m128i	lo = _mm_set1_epi32(4096), hi = lo;
+
+		for (i = 0; i < 5; i++) {
+			__m128i a = _mm_loadu_si128((__m128i const *)(e + k + tap[i]));
+			__m128i b = _mm_loadu_si128((__m128i const *)(e + k + tap[i] + 1));
+
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), h[i]));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), h[i]));
+		}
+
+		/*  packs saturates to MIN_WORD..MAX_WORD like the reference  */
+		_mm_storeu_si128((__m128i *)(x + k), _mm_packs_epi32(
+			_mm_srai_epi32(lo, 13), _mm_srai_epi32(hi, 13)));
+	}
+}
+
+#undef	H_PAIR
+
+static void rpe_grid_energies_sse2 P2((x, L_EM),
+	word		* x,		/* [0..39]	IN	*/
+	longword	* L_EM)		/* [0..3]	OUT	*/
+{
+	__m128i	y[5];
+	int	k, m;
+
+	for (k = 0; k < 5; k++)
+		y[k] = _mm_srai_epi16(_mm_loadu_si128((__m128i const *)(x + 8 * k)), 2);
+
+	for (m = 0; m < 4; m++) {
+		__m128i	acc = _mm_setzero_si128();
+
+		for (k = 0; k < 5; k++) acc = _mm_add_epi32(acc, _mm_madd_epi16(y[k],
+			_mm_and_si128(y[k], _mm_load_si128((__m128i const *)(grid_mask[m] + 8 * k)))));
+		L_EM[m] = hsum_sse2(acc) << 1;
+	}
+}
+
+#endif	/* GSM_SIMD_SSE2 */
+
+#ifdef	GSM_SIMD_NEON
+
+static void weighting_filter_neon P2((e, x),
+	word	* e,		/* [0..49]	IN	*/
+	word	* x)		/* [0..39]	OUT	*/
+{
+	static const int	tap[9] = { 0, 1, 3, 4, 5, 6, 7, 9, 10 };
+	static const word	H[9]   = { -134, -374, 2054, 5741, 8192,
+					   5741, 2054, -374, -134 };
+	int			k, i;
+
+	for (k = 0; k < 40; k += 8) {
+		int32x4_t	lo = vdupq_n_s32(4096), hi = lo;
+
+		for (i = 0; i < 9; i++) {
+			int16x8_t v = vld1q_s16(e + k + tap[i]);
+			lo = vmlal_n_s16(lo, vget_low_s16(v),  H[i]);
+			hi = vmlal_n_s16(hi, vget_high_s16(v), H[i]);
+		}
+
+		vst1q_s16(x + k, vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 13)),
+					      vqmovn_s32(vshrq_n_s32(hi, 13))));
+	}
+}
+
+static void rpe_grid_energies_neon P2((x, L_EM),
+	word		* x,		/* [0..39]	IN	*/
+	longword	* L_EM)		/* [0..3]	OUT	*/
+{
+	int16x8_t	y[5];
+	int		k, m;
+
+	for (k = 0; k < 5; k++) y[k] = vshrq_n_s16(vld1q_s16(x + 8 * k), 2);
+
+	for (m = 0; m < 4; m++) {
+		int32x4_t	acc = vdupq_n_s32(0);
+
+		for (k = 0; k < 5; k++) {
+			int16x8_t z = vandq_s16(y[k], vld1q_s16(grid_mask[m] + 8 * k));
+			acc = vmlal_s16(acc, vget_low_s16(y[k]),  vget_low_s16(z));
+			acc = vmlal_s16(acc, vget_high_s16(y[k]), vget_high_s16(z));
+		}
+		L_EM[m] = hsum_neon(acc) << 1;
+	}
+}
+
+#endif	/* GSM_SIMD_NEON */
+
+int gsm_simd_weighting_filter P2((e, x),
+	word	* e,		/* [0..49]	IN	*/
+	word	* x)		/* [0..39]	OUT	*/
+{
+#if defined(GSM_SIMD_SSE2)
+	weighting_filter_sse2(e, x);
+	return 1;
+#elif defined(GSM_SIMD_NEON)
+	weighting_filter_neon(e, x);
+	return 1;
+#else
+	(void)e; (void)x;
+	return 0;
+#endif
+}
+
+int gsm_simd_rpe_grid_energies P2((x, L_EM),
+	word		* x,		/* [0..39]	IN	*/
+	longword	* L_EM)		/* [0..3]	OUT	*/
+{
+#if defined(GSM_SIMD_SSE2)
+	rpe_grid_energies_sse2(x, L_EM);
+	return 1;
+#elif defined(GSM_SIMD_NEON)
+	rpe_grid_energies_neon(x, L_EM);
+	return 1;
+#else
+	(void)x; (void)L_EM;
+	return 0;
+#endif
+}
+
+/*
+ *  4.2.10 / 4.3.4 Short term lattice filters, one stream per lane.
+ *
+ *  The lattice is serial in time, so instead of vectorising one stream
+ *  the kernels run GSM_LANES independent streams side by side.  Every
+ *  array is interleaved: x[k * GSM_LANES + lane].
+ *
+ *  LARp_to_rp() never produces MIN_WORD, so GSM_MULT_R's MIN_WORD *
+ *  MIN_WORD corner can't occur and one rounding multiply serves both
+ *  the analysis and the synthesis (gsm_mult_r) form.
+ */
+
+#ifdef	GSM_SIMD_SSE2
+
+static __m128i mult_r_sse2 P2((a, b), __m128i a, __m128i b)
+{
+	/*  (a * b + 16384) >> 15 from the two halves of the 32-bit product:
+	 *  bits 15..30 of the product, plus bit 14 for the rounding.
+	 */
+	__m128i lo = _mm_mullo_epi16(a, b);
+	__m128i hi = _mm_mulhi_epi16(a, b);
+
+	return _mm_add_epi16(
+		_mm_or_si128(_mm_slli_epi16(hi, 1), _mm_srli_epi16(lo, 15)),
+		_mm_and_si128(_mm_srli_epi16(lo, 14), _mm_set1_epi16(1)));
+}
+
+static void short_term_analysis_sse2 P4((rp, u, k_n, s),
+	word	* rp,		/* [0..7][lanes]	IN	*/
+	word	* u,		/* [0..7][lanes]	IN/OUT	*/
+	int	k_n,
+	word	* s)		/* [0..k_n-1][lanes]	IN/OUT	*/
+{
+	__m128i	rpv[8], uv[8];
+	__m128i	di, sav, ui, zzz;
+	int	i;
+
+	for (i = 0; i < 8; i++) {
+		rpv[i] = _mm_loadu_si128((__m128i const *)(rp + i * GSM_LANES));
+		uv[i]  = _mm_loadu_si128((__m128i const *)(u  + i * GSM_LANES));
+	}
+
+	for (; k_n--; s += GSM_LANES) {
+
+		di = sav = _mm_loadu_si128((__m128i const *)s);
+
+		for (i = 0; i < 8; i++) {
+			ui    = uv[i];
+			uv[i] = sav;
+
+			zzz   = mult_r_sse2(rpv[i], di);
+			sav   = _mm_adds_epi16(ui, zzz);
+
+			zzz   = mult_r_sse2(rpv[i], ui);
+			di    = _mm_adds_epi16(di, zzz);
+		}
+
+		_mm_storeu_si128((__m128i *)s, di);
+	}
+
+	for (i = 0; i < 8; i++) _mm_storeu_si128((__m128i *)(u + i * GSM_LANES), uv[i]);
+}
+
+static void short_term_synthesis_sse2 P5((rrp, v, k, wt, sr),
+	word	* rrp,		/* [0..7][lanes]	IN	*/
+	word	* v,		/* [0..8][lanes]	IN/OUT	*/
+	int	k,
+	word	* wt,		/* [0..k-1][lanes]	IN	*/
+	word	* sr)		/* [0..k-1][lanes]	OUT	*/
+{
+	__m128i	rrpv[8], vv[9];
+	__m128i	sri;
+	int	i;
+
+	for (i = 0; i < 8; i++) rrpv[i] = _mm_loadu_si128((__m128i const *)(rrp + i * GSM_LANES));
+	for (i = 0; i < 9; i++) vv[i]   = _mm_loadu_si128((__m128i const *)(v   + i * GSM_LANES));
+
+	for (; k--; wt += GSM_LANES, sr += GSM_LANES) {
+
+		sri = _mm_loadu_si128((__m128i const *)wt);
+
+		for (i = 8; i--;) {
+			sri     = _mm_subs_epi16(sri, mult_r_sse2(rrpv[i], vv[i]));
+			vv[i+1] = _mm_adds_epi16(vv[i], mult_r_sse2(rrpv[i], sri));
+		}
+
+		_mm_storeu_si128((__m128i *)sr, vv[0] = sri);
+	}
+
+	for (i = 0; i < 9; i++) _mm_storeu_si128((__m128i *)(v + i * GSM_LANES), vv[i]);
+}
+
+#endif	/* GSM_SIMD_SSE2 */
+
+#ifdef	GSM_SIMD_NEON
+
+/*  vqrdmulhq_s16 is (2 * a * b + 32768) >> 16 = (a * b + 16384) >> 15.
+ */
+
+static void short_term_analysis_neon P4((rp, u, k_n, s),
+	word	* rp,		/* [0..7][lanes]	IN	*/
+	word	* u,		/* [0..7][lanes]	IN/OUT	*/
+	int	k_n,
+	word	* s)		/* [0..k_n-1][lanes]	IN/OUT	*/
+{
+	int16x8_t	rpv[8], uv[8];
+	int16x8_t	di, sav, ui;
+	int		i;
+
+	for (i = 0; i < 8; i++) {
+		rpv[i] = vld1q_s16(rp + i * GSM_LANES);
+		uv[i]  = vld1q_s16(u  + i * GSM_LANES);
+	}
+
+	for (; k_n--; s += GSM_LANES) {
+
+		di = sav = vld1q_s16(s);
+
+		for (i = 0; i < 8; i++) {
+			ui    = uv[i];
+			uv[i] = sav;
+
+			sav   = vqaddq_s16(ui, vqrdmulhq_s16(rpv[i], di));
+			di    = vqaddq_s16(di, vqrdmulhq_s16(rpv[i], ui));
+		}
+
+		vst1q_s16(s, di);
+	}
+
+	for (i = 0; i < 8; i++) vst1q_s16(u + i * GSM_LANES, uv[i]);
+}
+
+static void short_term_synthesis_neon P5((rrp, v, k, wt, sr),
+	word	* rrp,		/* [0..7][lanes]	IN	*/
+	word	* v,		/* [0..8][lanes]	IN/OUT	*/
+	int	k,
+	word	* wt,		/* [0..k-1][lanes]	IN	*/
+	word	* sr)		/* [0..k-1][lanes]	OUT	*/
+{
+	int16x8_t	rrpv[8], vv[9];
+	int16x8_t	sri;
+	int		i;
+
+	for (i = 0; i < 8; i++) rrpv[i] = vld1q_s16(rrp + i * GSM_LANES);
+	for (i = 0; i < 9; i++) vv[i]   = vld1q_s16(v   + i * GSM_LANES);
+
+	for (; k--; wt += GSM_LANES, sr += GSM_LANES) {
+
+		sri = vld1q_s16(wt);
+
+		for (i = 8; i--;) {
+			sri     = vqsubq_s16(sri, vqrdmulhq_s16(rrpv[i], vv[i]));
+			vv[i+1] = vqaddq_s16(vv[i], vqrdmulhq_s16(rrpv[i], sri));
+		}
+
+		vst1q_s16(sr, vv[0] = sri);
+	}
+
+	for (i = 0; i < 9; i++) vst1q_s16(v + i * GSM_LANES, vv[i]);
+}
+
+#endif	/* GSM_SIMD_NEON */
+
+int gsm_simd_available P0()
+{
+#if defined(GSM_SIMD_SSE2) || defined(GSM_SIMD_NEON)
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+#if !defined(GSM_SIMD_SSE2) && !defined(GSM_SIMD_NEON)
+
+/*  Reference arithmetic, lane by lane, for targets without a kernel.
+ *  Every lane runs whatever n is, so the multi-stream filters don't
+ *  come here (see gsm_simd_available); it keeps the kernels complete.
+ */
+
+static void short_term_analysis_lanes P4((rp, u, k_n, s),
+	word	* rp,		/* [0..7][lanes]	IN	*/
+	word	* u,		/* [0..7][lanes]	IN/OUT	*/
+	int	k_n,
+	word	* s)		/* [0..k_n-1][lanes]	IN/OUT	*/
+{
+	register int		i, lane;
+	register word		di, zzz, ui, sav, rpi;
+	register longword	ltmp;
+
+	for (; k_n--; s += GSM_LANES) for (lane = 0; lane < GSM_LANES; lane++) {
+
+		di = sav = s[lane];
+
+		for (i = 0; i < 8; i++) {
+			ui    = u[i * GSM_LANES + lane];
+			rpi   = rp[i * GSM_LANES + lane];
+			u[i * GSM_LANES + lane] = sav;
+
+			zzz   = GSM_MULT_R(rpi, di);
+			sav   = GSM_ADD(   ui,  zzz);
+
+			zzz   = GSM_MULT_R(rpi, ui);
+			di    = GSM_ADD(   di,  zzz );
+		}
+
+		s[lane] = di;
+	}
+}
+
+static void short_term_synthesis_lanes P5((rrp, v, k, wt, sr),
+	word	* rrp,		/* [0..7][lanes]	IN	*/
+	word	* v,		/* [0..8][lanes]	IN/OUT	*/
+	int	k,
+	word	* wt,		/* [0..k-1][lanes]	IN	*/
+	word	* sr)		/* [0..k-1][lanes]	OUT	*/
+{
+	register int		i, lane;
+	register word		sri, tmp;
+	register longword	ltmp;
+
+	for (; k--; wt += GSM_LANES, sr += GSM_LANES) for (lane = 0; lane < GSM_LANES; lane++) {
+
+		sri = wt[lane];
+
+		for (i = 8; i--;) {
+			tmp  = GSM_MULT_R(rrp[i * GSM_LANES + lane], v[i * GSM_LANES + lane]);
+			sri  = GSM_SUB( sri, tmp );
+
+			tmp  = GSM_MULT_R(rrp[i * GSM_LANES + lane], sri);
+			v[(i+1) * GSM_LANES + lane] = GSM_ADD( v[i * GSM_LANES + lane], tmp );
+		}
+
+		sr[lane] = v[lane] = sri;
+	}
+}
+
+#endif	/* !GSM_SIMD_SSE2 && !GSM_SIMD_NEON */
+
+void gsm_simd_short_term_analysis P4((rp, u, k_n, s),
+	word	* rp,		/* [0..7][lanes]	IN	*/
+	word	* u,		/* [0..7][lanes]	IN/OUT	*/
+	int	k_n,
+	word	* s)		/* [0..k_n-1][lanes]	IN/OUT	*/
+{
+#if defined(GSM_SIMD_SSE2)
+	short_term_analysis_sse2(rp, u, k_n, s);
+#elif defined(GSM_SIMD_NEON)
+	short_term_analysis_neon(rp, u, k_n, s);
+#else
+	short_term_analysis_lanes(rp, u, k_n, s);
+#endif
+}
+
+void gsm_simd_short_term_synthesis P5((rrp, v, k, wt, sr),
+	word	* rrp,		/* [0..7][lanes]	IN	*/
+	word	* v,		/* [0..8][lanes]	IN/OUT	*/
+	int	k,
+	word	* wt,		/* [0..k-1][lanes]	IN	*/
+	word	* sr)		/* [0..k-1][lanes]	OUT	*/
+{
+#if defined(GSM_SIMD_SSE2)
+	short_term_synthesis_sse2(rrp, v, k, wt, sr);
+#elif defined(GSM_SIMD_NEON)
+	short_term_synthesis_neon(rrp, v, k, wt, sr);
+#else
+	short_term_synthesis_lanes(rrp, v, k, wt, sr);
+#endif
+}
@@ -0,0 +1,105 @@
+#include "AllocationHooks.h"
+#include "AllocationGuard.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if ! RSTC_ALLOCATION_GUARD
+ #error "the allocation hooks need ScopedAllocationGuard built in; define RSTC_ALLOCATION_GUARD=1"
+#endif
+
+namespace
+{
+    std::atomic<int> numViolations { 0 };
+
+    void check() noexcept
+    {
+        if (ScopedAllocationGuard::isActive())
+            ++numViolations;
+    }
+
+    void* allocate(std::size_t size) noexcept
+    {
+        check();
+        return std::malloc(size > 0 ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        check();
+
+        size = size > 0 ? size : 1;
+        auto bytes = static_cast<std::size_t>(alignment);
+
+       #if defined(_WIN32)
+        return _aligned_malloc(size, bytes);
+       #else
+        void* memory = nullptr;
+        return posix_memalign(&memory, bytes < sizeof(void*) ? sizeof(void*) : bytes, size) == 0 ? memory : nullptr;
+       #endif
+    }
+
+    void release(void* memory) noexcept
+    {
+        if (memory != nullptr)
+            check();
+
+        std::free(memory);
+    }
+
+    void releaseAligned(void* memory) noexcept
+    {
+        if (memory != nullptr)
+            check();
+
+       #if defined(_WIN32)
+        _aligned_free(memory);
+       #else
+        std::free(memory);
+       #endif
+    }
+
+    void* allocateOrThrow(std::size_t size)
+    {
+        if (void* memory = allocate(size))
+            return memory;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+    {
+        if (void* memory = allocateAligned(size, alignment))
+            return memory;
+
+        throw std::bad_alloc();
+    }
+}
+
+int AllocationHooks::getNumViolations() noexcept { return numViolations.load(); }
+
+//==============================================================================
+void* operator new  (std::size_t size)                                { return allocateOrThrow(size); }
+void* operator new[](std::size_t size)                                { return allocateOrThrow(size); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new  (std::size_t size, std::align_val_t alignment)                                { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment)                                { return allocateAlignedOrThrow(size, alignment); }
+void* operator new  (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete  (void* memory) noexcept                               { release(memory); }
+void operator delete[](void* memory) noexcept                               { release(memory); }
+void operator delete  (void* memory, const std::nothrow_t&) noexcept        { release(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept        { release(memory); }
+void operator delete  (void* memory, std::size_t) noexcept                  { release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept                  { release(memory); }
+
+void operator delete  (void* memory, std::align_val_t) noexcept                          { releaseAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept                          { releaseAligned(memory); }
+void operator delete  (void* memory, std::align_val_t, const std::nothrow_t&) noexcept   { releaseAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept   { releaseAligned(memory); }
+void operator delete  (void* memory, std::size_t, std::align_val_t) noexcept             { releaseAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept             { releaseAligned(memory); }
@@ -0,0 +1,9 @@
+#pragma once
+
+// Replacements for every global operator new/delete, linked into the test targets
+// only. Each one counts a violation when it runs under a ScopedAllocationGuard.
+namespace AllocationHooks
+{
+    // allocations and releases made under a guard since the program started
+    int getNumViolations() noexcept;
+}
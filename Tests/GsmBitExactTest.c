@@ -0,0 +1,252 @@
+/*
+ *  Checks that every way of running the GSM codec gives the reference
+ *  output, bit for bit:
+ *
+ *	- gsm_encode/gsm_decode against checksums of unmodified libgsm 1.0
+ *	  on the same corpus (the vector LPC, LTP and RPE kernels);
+ *	- gsm_encode_multi/gsm_decode_multi for 1 to GSM_MAX_STREAMS
+ *	  streams against the single stream calls (the batched lattices);
+ *	- gsm_transcode and gsm_transcode_multi against gsm_encode followed
+ *	  by gsm_decode (no packing in between).
+ *
+ *  The corpus is made with integer arithmetic only, so the checksums do
+ *  not depend on the platform's libm.  To regenerate them, build this
+ *  file with RSTC_GSM_PRINT_REFERENCE defined against the original
+ *  libgsm sources, which only have the single stream calls.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gsm.h"
+
+#ifndef	GSM_MAX_STREAMS
+#define	GSM_MAX_STREAMS	8
+#endif
+
+#define	NUM_STREAMS	GSM_MAX_STREAMS
+#define	NUM_FRAMES	300
+#define	FRAME_BYTES	33
+
+/*  unmodified libgsm 1.0.x on this corpus  */
+#define	REFERENCE_FRAMES	0x9b614940UL
+#define	REFERENCE_DECODED	0x0e5c6cc0UL
+
+static gsm_signal	input   [NUM_STREAMS][NUM_FRAMES][160];
+static gsm_byte		frames  [NUM_STREAMS][NUM_FRAMES][FRAME_BYTES];
+static gsm_signal	decoded [NUM_STREAMS][NUM_FRAMES][160];
+
+static gsm_byte		multi_frame   [NUM_STREAMS][FRAME_BYTES];
+static gsm_signal	multi_decoded [NUM_STREAMS][160];
+
+static unsigned long fnv1a(unsigned long hash, const unsigned char * p, int n)
+{
+	while (n--) hash = ((hash ^ *p++) * 16777619UL) & 0xffffffffUL;
+	return hash;
+}
+
+static unsigned long hash_frames(void)
+{
+	unsigned long	hash = 2166136261UL;
+	int		stream, frame;
+
+	for (stream = 0; stream < NUM_STREAMS; stream++)
+		for (frame = 0; frame < NUM_FRAMES; frame++)
+			hash = fnv1a(hash, frames[stream][frame], FRAME_BYTES);
+	return hash;
+}
+
+static unsigned long hash_decoded(void)
+{
+	unsigned long	hash = 2166136261UL;
+	int		stream, frame, k;
+
+	/* byte order fixed, so big endian machines agree */
+	for (stream = 0; stream < NUM_STREAMS; stream++)
+		for (frame = 0; frame < NUM_FRAMES; frame++)
+			for (k = 0; k < 160; k++) {
+				unsigned	v = (unsigned short)decoded[stream][frame][k];
+				unsigned char	b[2];
+
+				b[0] = (unsigned char)(v & 0xff);
+				b[1] = (unsigned char)(v >> 8);
+				hash = fnv1a(hash, b, 2);
+			}
+	return hash;
+}
+
+static int clamp16(long v)
+{
+	return v > 32767 ? 32767 : v < -32768 ? -32768 : (int)v;
+}
+
+/*  -amplitude..amplitude over period samples  */
+static long triangle(long n, long period, long amplitude)
+{
+	long	t = n % period;
+	long	half = period / 2;
+
+	return t < half ? -amplitude + 2 * amplitude * t / half
+			: amplitude - 2 * amplitude * (t - half) / (period - half);
+}
+
+/*  One signal family per stream: noise, tones, clipping, silence...  */
+static void make_corpus(void)
+{
+	unsigned long	seed = 12345;
+	int		stream, frame, k;
+
+	for (stream = 0; stream < NUM_STREAMS; stream++)
+		for (frame = 0; frame < NUM_FRAMES; frame++)
+			for (k = 0; k < 160; k++) {
+				long	n = (long)frame * 160 + k;
+				long	noise, v;
+
+				seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+				noise = (long)((seed >> 16) & 0xffff) - 32768;
+
+				switch (stream % 8) {
+				case 0:	/* full scale white noise */
+					v = noise;
+					break;
+				case 1:	/* tone, pitch stepping every frame */
+					v = triangle(n, 20 + frame % 60, 12000);
+					break;
+				case 2:	/* square wave, swelling */
+					v = (n / 37) % 2 ? 300 + frame * 100 : -300 - frame * 100;
+					break;
+				case 3:	/* silence with the odd click */
+					v = n % 997 == 0 ? 30000 : 0;
+					break;
+				case 4:	/* voiced: tone under a slow envelope, plus breath */
+					v = triangle(n, 57, 9000) * triangle(n, 4001, 1000) / 1000
+					  + triangle(n, 23, 3000) + noise / 64;
+					break;
+				case 5:	/* two tones driven into the rails */
+					v = 3 * (triangle(n, 91, 20000) + triangle(n, 13, 9000));
+					break;
+				case 6:	/* very quiet noise */
+					v = noise / 512;
+					break;
+				default: /* falling chirp */
+					v = triangle(n, 200 - (n / 320) % 180, 16000);
+					break;
+				}
+
+				input[stream][frame][k] = (gsm_signal)clamp16(v);
+			}
+}
+
+/*  gsm_encode/gsm_decode, one stream at a time: the reference  */
+static void run_reference(void)
+{
+	int	stream, frame;
+
+	for (stream = 0; stream < NUM_STREAMS; stream++) {
+		gsm	e = gsm_create();
+		gsm	d = gsm_create();
+
+		for (frame = 0; frame < NUM_FRAMES; frame++) {
+			gsm_encode(e, input[stream][frame], frames[stream][frame]);
+			gsm_decode(d, frames[stream][frame], decoded[stream][frame]);
+		}
+
+		gsm_destroy(e);
+		gsm_destroy(d);
+	}
+}
+
+#ifndef	RSTC_GSM_PRINT_REFERENCE
+
+static int check_multi(int n)
+{
+	gsm		e[GSM_MAX_STREAMS], d[GSM_MAX_STREAMS];
+	gsm		te[GSM_MAX_STREAMS], td[GSM_MAX_STREAMS];
+	gsm		se[GSM_MAX_STREAMS], sd[GSM_MAX_STREAMS];
+	gsm_signal	* in[GSM_MAX_STREAMS], * out[GSM_MAX_STREAMS];
+	gsm_byte	* code[GSM_MAX_STREAMS];
+	gsm_signal	single[160];
+	int		stream, frame, failures = 0;
+
+	for (stream = 0; stream < n; stream++) {
+		e[stream]  = gsm_create();	d[stream]  = gsm_create();
+		te[stream] = gsm_create();	td[stream] = gsm_create();
+		se[stream] = gsm_create();	sd[stream] = gsm_create();
+		code[stream] = multi_frame[stream];
+		out[stream]  = multi_decoded[stream];
+	}
+
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		for (stream = 0; stream < n; stream++)
+			in[stream] = input[stream][frame];
+
+		gsm_encode_multi(n, e, in, code);
+		for (stream = 0; stream < n; stream++)
+			failures += memcmp(code[stream], frames[stream][frame], FRAME_BYTES) != 0;
+
+		/* decode the reference frames, so a coder failure doesn't cascade */
+		for (stream = 0; stream < n; stream++)
+			code[stream] = frames[stream][frame];
+		failures += gsm_decode_multi(n, d, code, out) != 0;
+		for (stream = 0; stream < n; stream++) {
+			failures += memcmp(out[stream], decoded[stream][frame], sizeof(single)) != 0;
+			code[stream] = multi_frame[stream];
+		}
+
+		gsm_transcode_multi(n, te, td, in, out);
+		for (stream = 0; stream < n; stream++)
+			failures += memcmp(out[stream], decoded[stream][frame], sizeof(single)) != 0;
+
+		for (stream = 0; stream < n; stream++) {
+			gsm_transcode(se[stream], sd[stream], in[stream], single);
+			failures += memcmp(single, decoded[stream][frame], sizeof(single)) != 0;
+		}
+	}
+
+	for (stream = 0; stream < n; stream++) {
+		gsm_destroy(e[stream]);		gsm_destroy(d[stream]);
+		gsm_destroy(te[stream]);	gsm_destroy(td[stream]);
+		gsm_destroy(se[stream]);	gsm_destroy(sd[stream]);
+	}
+
+	return failures;
+}
+
+#endif	/* RSTC_GSM_PRINT_REFERENCE */
+
+int main(void)
+{
+	unsigned long	frames_hash, decoded_hash;
+	int		failures = 0;
+
+	make_corpus();
+	run_reference();
+
+	frames_hash  = hash_frames();
+	decoded_hash = hash_decoded();
+
+#ifdef	RSTC_GSM_PRINT_REFERENCE
+	printf("#define\tREFERENCE_FRAMES\t0x%08lxUL\n", frames_hash);
+	printf("#define\tREFERENCE_DECODED\t0x%08lxUL\n", decoded_hash);
+#else
+	if (frames_hash != REFERENCE_FRAMES || decoded_hash != REFERENCE_DECODED) {
+		printf("gsm_encode/gsm_decode: checksums %08lx %08lx, expected %08lx %08lx\n",
+			frames_hash, decoded_hash, REFERENCE_FRAMES, REFERENCE_DECODED);
+		failures++;
+	}
+
+	{
+		int	n;
+
+		for (n = 1; n <= GSM_MAX_STREAMS; n++) {
+			int	f = check_multi(n);
+
+			if (f) printf("%d streams: %d mismatching frames\n", n, f);
+			failures += f;
+		}
+	}
+
+	printf("%s: %d streams x %d frames\n", failures ? "FAILED" : "passed", NUM_STREAMS, NUM_FRAMES);
+#endif
+	return failures != 0;
+}